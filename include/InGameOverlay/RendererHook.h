@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <cstdint>
+#include <cstddef>
 
 #include "RendererResource.h"
 
@@ -114,6 +115,45 @@ struct ScreenshotCallbackParameter_t
 
 typedef void (*ScreenshotCallback_t)(ScreenshotCallbackParameter_t const* screenshot, void* userParameter);
 
+/// <summary>
+///   What the overlay resources use, see RendererHook_t::GetResourceStats.
+/// </summary>
+struct RendererResourceStats_t
+{
+    // Textures allocated by the renderer, loaded or not.
+    uint32_t Textures;
+    uint32_t LoadedTextures;
+    // Bytes of the loaded textures.
+    uint64_t ResidentBytes;
+    uint32_t PendingUploads;
+    uint64_t PendingUploadBytes;
+    // Texture descriptors in use and allocated, 0 if the renderer doesn't allocate descriptors.
+    uint32_t UsedDescriptors;
+    uint32_t DescriptorCapacity;
+    // Memory handed out by RendererResource_t::BeginWrite and not released yet.
+    uint64_t StagingBytes;
+    // Uploads done during the last frame.
+    uint32_t FrameUploads;
+    uint64_t FrameUploadBytes;
+    // Frames between a load request and its upload, over the last uploads.
+    uint32_t LoadLatencyP50;
+    uint32_t LoadLatencyP90;
+    uint32_t LoadLatencyP99;
+};
+
+/// <summary>
+///   One resource to create with RendererHook_t::CreateResources.
+///   Data is attached the same way as CreateAndAttachResource, it can be nullptr to attach nothing.
+/// </summary>
+struct RendererResourceDesc_t
+{
+    const void* Data;
+    uint32_t Width;
+    uint32_t Height;
+    RendererResourcePriority_t Priority;
+    RendererResourceFormat_t Format;
+};
+
 /// <summary>
 ///   The renderer hook.
 ///     ResourceAutoLoad_t: Default value is ResourceAutoLoad_t::Batch
@@ -127,6 +167,11 @@ public:
 
     // TODO: Deprecated direct use of thoses and use either a setter or plain C function pointers with void* user parameter.
     std::function<void()> OverlayProc;
+    /// <summary>
+    ///   Called when the hook state changes. Resources don't need to be recreated on OverlayHookState::Removing:
+    ///   the textures of resources with borrowed data, or created from a file, are uploaded again once the hook is Ready.
+    ///   Owned data is released after its upload, so those resources come back empty, see RendererResource_t::IsLost, and have to be attached again.
+    /// </summary>
     std::function<void(OverlayHookState)> OverlayHookReady;
 
     virtual void SetScreenshotCallback(ScreenshotCallback_t callback, void* userParam) = 0;
@@ -166,6 +211,35 @@ public:
     /// <returns></returns>
     virtual void HideOverlayInputs(bool hide) = 0;
 
+    /// <summary>
+    ///   Reads the overlay inputs on a dedicated thread instead of waiting for the application to poll its events.
+    ///   Only the X11 based renderers support it, the other renderers will return false.
+    ///   The X11 based renderers always run an input thread watching the toggle keys, so the event hooks skip their filtering while the overlay is closed.
+    ///   Disabling the dedicated input thread only stops it from reading the overlay inputs.
+    /// </summary>
+    /// <param name="enabled">
+    ///   Set to true to start the input thread, false to stop it.
+    /// </param>
+    /// <returns></returns>
+    virtual bool SetDedicatedInputThread(bool enabled) = 0;
+
+    /// <summary>
+    ///   Sums the consecutive mouse wheel events into a single overlay wheel event while the overlay has the inputs.
+    ///   Only the X11 based renderers support it, the other renderers will return false.
+    /// </summary>
+    /// <param name="coalesce">
+    ///   Set to true to merge the wheel events, false to send them one by one.
+    /// </param>
+    /// <returns></returns>
+    virtual bool SetCoalesceScrollEvents(bool coalesce) = 0;
+
+    /// <summary>
+    ///   Number of input events merged or dropped before reaching the overlay since the hook started.
+    ///   Always 0 on the renderers that don't coalesce their inputs.
+    /// </summary>
+    /// <returns></returns>
+    virtual uint64_t GetCoalescedInputEventCount() = 0;
+
     /// <summary>
     ///   Returns the hook state. If its started, then the functions are hooked (redirected to InGameOverlay) and will intercepts the application frame rendering.
     /// </summary>
@@ -196,6 +270,50 @@ public:
     /// <param name="batchSize"></param>
     virtual void SetAutoLoadBatchSize(uint32_t batchSize) = 0;
 
+    /// <summary>
+    ///   Gets the texture memory budget in bytes, 0 if there is no limit.
+    /// </summary>
+    /// <returns></returns>
+    virtual uint64_t GetTextureMemoryBudget() = 0;
+
+    /// <summary>
+    ///   Sets how much GPU memory the resources can use. When it is exceeded, the least recently drawn resources are unloaded
+    ///   and will be loaded again from their attached data the next time GetResourceId is called.
+    ///   Resources drawn in the current frame, or that don't have their data anymore, are never unloaded.
+    ///   On Vulkan, the budget is also lowered to what VK_EXT_memory_budget reports as available, if supported,
+    ///   even when no budget is set.
+    /// </summary>
+    /// <param name="budget">The budget in bytes, 0 to remove the limit.</param>
+    virtual void SetTextureMemoryBudget(uint64_t budget) = 0;
+
+    /// <summary>
+    ///   Gets if resources with the same content share their texture.
+    /// </summary>
+    /// <returns></returns>
+    virtual bool GetResourceDeduplication() = 0;
+
+    /// <summary>
+    ///   When enabled, the resources attached afterward are hashed in the background, and the ones with the same pixels and size share one texture.
+    ///   It delays their first load by the time it takes to hash them, and borrowed pixels are copied for their upload
+    ///   since the resource that attached them can go away before the shared texture is loaded. Disabled by default.
+    /// </summary>
+    /// <param name="enabled"></param>
+    virtual void SetResourceDeduplication(bool enabled) = 0;
+
+    /// <summary>
+    ///   Gets the directory where the decoded images are cached.
+    /// </summary>
+    /// <returns>An empty string if the cache is disabled</returns>
+    virtual const char* GetResourceCacheDirectory() = 0;
+
+    /// <summary>
+    ///   Sets an existing directory where CreateResourceFromEncoded and CreateResourceFromFile store the images they decode, named after the hash of their encoded bytes.
+    ///   The next times the same image is created, even in another session, its pixels are mapped from the cache and uploaded without being decoded.
+    ///   Applies to the images created afterward, disabled by default. Animated images are not cached.
+    /// </summary>
+    /// <param name="path">*Can be nullptr*. The cache directory, nullptr or empty to disable the cache</param>
+    virtual void SetResourceCacheDirectory(const char* path) = 0;
+
     /// <summary>
     ///   Creates an image resource that can be setup and used later.
     /// </summary>
@@ -217,7 +335,99 @@ public:
     /// <returns></returns>
     virtual RendererResource_t* CreateAndAttachResource(const void* image_data, uint32_t width, uint32_t height) = 0;
 
+    /// <summary>
+    ///   Creates many resources at once, from a single allocation. The renderer reserves their
+    ///   texture slots in one pass when the first of them is loaded.
+    ///   Each resource is still deleted on its own with RendererResource_t::Delete.
+    /// </summary>
+    /// <param name="count">
+    ///   The number of resources to create.
+    /// </param>
+    /// <param name="descs">
+    ///   count resource descriptions.
+    /// </param>
+    /// <param name="resources">
+    ///   Receives the count created resources.
+    /// </param>
+    /// <returns>False if nothing was created</returns>
+    virtual bool CreateResources(uint32_t count, RendererResourceDesc_t const* descs, RendererResource_t** resources) = 0;
+
+    /// <summary>
+    ///   Creates an image resource from an encoded image (PNG, JPEG, BMP, TGA or GIF).
+    ///   The image is decoded in the background, the resource will report IsLoaded() once it is decoded and uploaded.
+    ///   Animated GIFs are attached as an animation, see RendererResource_t::AttachAnimation.
+    /// </summary>
+    /// <param name="encoded_data">
+    ///   The encoded image. It is copied, you can free it as soon as this returns.
+    /// </param>
+    /// <param name="encoded_size">
+    ///   The encoded image size in bytes.
+    /// </param>
+    /// <returns></returns>
+    virtual RendererResource_t* CreateResourceFromEncoded(const void* encoded_data, size_t encoded_size) = 0;
+
+    /// <summary>
+    ///   Same as CreateResourceFromEncoded, but the file is also read in the background.
+    /// </summary>
+    /// <param name="path">
+    ///   The image file path.
+    /// </param>
+    /// <returns></returns>
+    virtual RendererResource_t* CreateResourceFromFile(const char* path) = 0;
+
+    /// <summary>
+    ///   Creates an image resource from a KTX2 container, with all its mip levels.
+    ///   Only 2D images without supercompression are read, in RGBA8, BGRA8, R8, RG8, RGB565, RGBA16F, BC1, BC3, BC4, BC5, BC7 or ETC2 formats.
+    ///   sRGB formats are read as their UNORM counterpart, like every other resource. Renderers without mipmaps only load the first level.
+    /// </summary>
+    /// <param name="data">
+    ///   The KTX2 file content. It is copied, you can free it as soon as this returns.
+    /// </param>
+    /// <param name="size">
+    ///   The KTX2 file size in bytes.
+    /// </param>
+    /// <returns>nullptr if the container can't be read, or if the renderer can't sample its format</returns>
+    virtual RendererResource_t* CreateResourceFromKTX2(const void* data, size_t size) = 0;
+
+    /// <summary>
+    ///   Checks if resources in a format can be loaded. Uncompressed formats always can, they are expanded when the renderer can't sample them.
+    ///   Block compressed formats need the renderer support, so call it once the renderer is hooked.
+    /// </summary>
+    /// <param name="format"></param>
+    /// <returns></returns>
+    virtual bool IsResourceFormatSupported(RendererResourceFormat_t format) = 0;
+
+    /// <summary>
+    ///   Creates a tiled resource, for images too large to be attached to a single resource.
+    /// </summary>
+    /// <param name="width">
+    ///   The full image width.
+    /// </param>
+    /// <param name="height">
+    ///   The full image height.
+    /// </param>
+    /// <param name="tileSize">
+    ///   The tiles width and height.
+    /// </param>
+    /// <param name="cacheTiles">
+    ///   The maximum number of tiles kept loaded, it bounds the resource video memory to cacheTiles * tileSize * tileSize * 4 bytes.
+    /// </param>
+    /// <param name="provider">
+    ///   Fills the tiles when they are drawn.
+    /// </param>
+    /// <param name="userParameter">
+    ///   Passed to provider.
+    /// </param>
+    /// <returns>nullptr if a parameter is 0</returns>
+    virtual RendererTiledResource_t* CreateTiledResource(uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheTiles, RendererTileProviderCallback_t provider, void* userParameter) = 0;
+
     virtual void TakeScreenshot(ScreenshotType_t type) = 0;
+
+    /// <summary>
+    ///   Gets the resources counters, they are updated once per rendered frame.
+    /// </summary>
+    /// <returns></returns>
+    virtual RendererResourceStats_t GetResourceStats() = 0;
 };
 
 }
@@ -19,8 +19,73 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace InGameOverlay {
 
+/// <summary>
+/// Called when the library doesn't need an owned resource buffer anymore.
+/// </summary>
+typedef void (*RendererResourceReleaseCallback_t)(void* data, void* userParameter);
+
+class RendererResource_t;
+
+/// <summary>
+/// Called when a prefetched resource has been loaded onto the GPU.
+/// </summary>
+typedef void (*RendererResourceLoadedCallback_t)(RendererResource_t* resource, void* userParameter);
+
+/// <summary>
+/// The resource load priority. Visible resources (GetResourceId called this frame) are loaded before the others of the same priority.
+/// </summary>
+enum class RendererResourcePriority_t : uint8_t
+{
+    Low,
+    Normal,
+    High,
+};
+
+/// <summary>
+/// The attached pixels format. Renderers that can't sample a format natively get it expanded to RGBA8 before its upload.
+/// The block compressed formats can't be expanded, see RendererHook_t::IsResourceFormatSupported.
+/// The planar YUV formats are converted to RGB in a shader where the renderer allows it, on the CPU otherwise.
+/// </summary>
+enum class RendererResourceFormat_t : uint8_t
+{
+    RGBA8,
+    BGRA8,
+    // Grayscale, sampled as (R, R, R, 1).
+    R8,
+    // Alpha only, sampled as (1, 1, 1, A), for glyph sheets.
+    A8,
+    // Grayscale and alpha, sampled as (R, R, R, G).
+    RG8,
+    // 16 bits, red in the high bits.
+    RGB565,
+    // 4 half floats.
+    RGBA16F,
+    // 4x4 blocks of 8 bytes, RGB with 1 bit alpha.
+    BC1,
+    // 4x4 blocks of 16 bytes, RGBA.
+    BC3,
+    // 4x4 blocks of 8 bytes, sampled like R8.
+    BC4,
+    // 4x4 blocks of 16 bytes, sampled like RG8.
+    BC5,
+    // 4x4 blocks of 16 bytes, RGBA.
+    BC7,
+    // 4x4 blocks of 8 bytes, RGB.
+    ETC2RGB8,
+    // 4x4 blocks of 16 bytes, RGBA.
+    ETC2RGBA8,
+    // BT.601 limited range YUV 4:2:0, the Y plane followed by the interleaved UV plane.
+    NV12,
+    // BT.601 limited range YUV 4:2:0, the Y plane followed by the U plane and the V plane.
+    I420,
+};
+
 /// <summary>
 /// A renderer resource. It will be tied to the RendererHook that created it. Don't use it if you recycle the renderer hook.
 /// </summary>
@@ -29,13 +94,19 @@ class RendererResource_t
 protected:
     virtual ~RendererResource_t() {}
 
+    static void ReleaseVectorBuffer(void*, void* userParameter)
+    {
+        delete static_cast<std::vector<uint8_t>*>(userParameter);
+    }
+
 public:
     /// <summary>
     /// Deletes the resource.
     /// </summary>
     virtual void Delete() = 0;
     /// <summary>
-    /// Checks if the resource is loaded.
+    /// Checks if the resource is loaded. Width and Height can be called from any thread too,
+    /// as long as the resource is not attached, unloaded or deleted at the same time.
     /// </summary>
     /// <returns>Is loaded or not</returns>
     virtual bool IsLoaded() const = 0;
@@ -45,12 +116,27 @@ public:
     /// <returns>Can be loaded</returns>
     virtual bool HasAttachedResource() const = 0;
     /// <summary>
+    /// Returns if the texture went away, with the renderer device or a dropped upload, and the resource has nothing to load it from again.
+    /// Owned data, KTX2 content and pixels written with BeginWrite are released after their upload, those resources have to be attached again.
+    /// Borrowed data and files are loaded again on their own. It is updated by GetResourceId and Prefetch, use it on the same thread.
+    /// </summary>
+    /// <returns>Has to be attached again</returns>
+    virtual bool IsLost() const = 0;
+    /// <summary>
     /// Gets the resource id usable by ImGui::Image(). It will also trigger the autoload if set.
     /// If autoload is in batch mode, the loading can be deferred by a few frames. (at least 1)
     /// </summary>
     /// <returns>The ImGui's image handle, 0 if it is not ready</returns>
     virtual uint64_t GetResourceId() = 0;
     /// <summary>
+    /// Requests the resource load right now, without waiting for GetResourceId to be called. Use it on the same thread as GetResourceId.
+    /// The resource is not considered visible, so it is loaded after the visible resources of the same priority.
+    /// </summary>
+    /// <param name="loadedCallback">*Can be nullptr*. Called on the renderer thread once the resource is loaded, every frame of it for an animation, or right away if it already is. Not called if the resource is unloaded or attached again before that.</param>
+    /// <param name="userParameter">Passed to loadedCallback</param>
+    /// <returns>False if there is nothing to load yet (no attached resource, or its decode is not done)</returns>
+    virtual bool Prefetch(RendererResourceLoadedCallback_t loadedCallback = nullptr, void* userParameter = nullptr) = 0;
+    /// <summary>
     ///   Return the loaded or attached resource width.
     /// </summary>
     /// <returns></returns>
@@ -65,10 +151,109 @@ public:
     /// You are responsible to not outlive this object usage to the resource buffer.
     /// Attaching a new resource will trigger the autoload if it is enabled, else, the old resource will still be used until you unload it.
     /// </summary>
-    /// <param name="data">The resource raw data (in RGBA format)</param>
+    /// <param name="data">The resource raw data</param>
     /// <param name="width">The resource width</param>
     /// <param name="height">The resource height</param>
-    virtual void AttachResource(const void* data, uint32_t width, uint32_t height) = 0;
+    /// <param name="format">The data pixels format</param>
+    virtual void AttachResource(const void* data, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8) = 0;
+    /// <summary>
+    /// Attach a resource to this RendererResource, it will OWN the data.
+    /// The release callback is called as soon as the resource has been uploaded to the GPU, or when it is detached before that.
+    /// It can be called from the renderer thread. Once released, the resource can't be auto loaded again after an Unload.
+    /// A buffer too small for the image is released right away and the attached resource is left untouched.
+    /// </summary>
+    /// <param name="data">The resource raw data</param>
+    /// <param name="size">The data size in bytes</param>
+    /// <param name="width">The resource width</param>
+    /// <param name="height">The resource height</param>
+    /// <param name="releaseCallback">Called with data and userParameter to free the buffer</param>
+    /// <param name="userParameter">Passed to releaseCallback</param>
+    /// <param name="format">The data pixels format</param>
+    virtual void AttachResource(void* data, size_t size, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8) = 0;
+    /// <summary>
+    /// Same as the release callback overload, the buffer is moved in and freed once uploaded to the GPU.
+    /// Inline, the vector is allocated and freed on the caller side.
+    /// </summary>
+    /// <param name="data">The resource raw data</param>
+    /// <param name="width">The resource width</param>
+    /// <param name="height">The resource height</param>
+    /// <param name="format">The data pixels format</param>
+    inline void AttachResource(std::vector<uint8_t>&& data, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8)
+    {
+        auto buffer = new std::vector<uint8_t>(std::move(data));
+        AttachResource(buffer->data(), buffer->size(), width, height, &ReleaseVectorBuffer, buffer, format);
+    }
+    /// <summary>
+    /// Attach raw pixels stored in a file. The file is memory mapped and uploaded straight from the mapping,
+    /// then unmapped once the upload is done, the same way as an owned resource.
+    /// </summary>
+    /// <param name="path">The file path</param>
+    /// <param name="width">The resource width</param>
+    /// <param name="height">The resource height</param>
+    /// <param name="offset">Where the pixels start in the file, to skip a container header</param>
+    /// <param name="format">The file pixels format</param>
+    /// <returns>False if the file can't be mapped or is too small, the attached resource is left untouched</returns>
+    virtual bool AttachResourceFromFile(const char* path, uint32_t width, uint32_t height, uint64_t offset = 0, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8) = 0;
+    /// <summary>
+    /// Starts writing RGBA pixels straight into the renderer upload memory, so they are not copied again before the upload.
+    /// Renderers without mappable upload memory hand out a library owned buffer instead.
+    /// Nothing is attached until EndWrite is called. Don't wait on the renderer thread in between,
+    /// the renderer waits for the pending EndWrite calls before it frees its upload memory with its device.
+    /// If the device goes away before the pixels are uploaded, IsLost returns true and they have to be written again.
+    /// </summary>
+    /// <param name="width">The resource width</param>
+    /// <param name="height">The resource height</param>
+    /// <param name="pitch">Receives the number of bytes between the start of two rows</param>
+    /// <returns>The memory to write height rows into, nullptr if it can't be allocated</returns>
+    virtual void* BeginWrite(uint32_t width, uint32_t height, uint32_t* pitch) = 0;
+    /// <summary>
+    /// Attaches the pixels written since BeginWrite, the same way as an owned resource.
+    /// The memory returned by BeginWrite must not be used anymore.
+    /// </summary>
+    virtual void EndWrite() = 0;
+    /// <summary>
+    /// Attach an animation to this RendererResource, it will NOT OWN the frames.
+    /// Every frame is uploaded once in its own texture, GetResourceId then returns the frame to show at the time it is called,
+    /// so playing the animation costs no upload and the id is drawn whole, without atlas UVs or an atlas size limit.
+    /// It starts on the first GetResourceId call and loops. The current image is unloaded right away, attaching an image stops the animation.
+    /// </summary>
+    /// <param name="frames">The frames raw data, stored one after the other</param>
+    /// <param name="frameDurations">How long each frame is shown in milliseconds, 0 is shown 100ms like browsers do. Copied.</param>
+    /// <param name="frameCount">The number of frames</param>
+    /// <param name="width">The frames width</param>
+    /// <param name="height">The frames height</param>
+    /// <param name="format">The frames pixels format</param>
+    virtual void AttachAnimation(const void* frames, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8) = 0;
+    /// <summary>
+    /// Same as the borrowed overload, it will OWN the frames. The release callback is called once every frame has been uploaded to the GPU,
+    /// or when the animation is detached before that. It can be called from the renderer thread.
+    /// A buffer too small for frameCount frames is released right away and the attached resource is left untouched.
+    /// </summary>
+    /// <param name="frames">The frames raw data, stored one after the other</param>
+    /// <param name="size">The frames size in bytes</param>
+    /// <param name="frameDurations">How long each frame is shown in milliseconds, 0 is shown 100ms like browsers do. Copied.</param>
+    /// <param name="frameCount">The number of frames</param>
+    /// <param name="width">The frames width</param>
+    /// <param name="height">The frames height</param>
+    /// <param name="releaseCallback">Called with frames and userParameter to free the buffer</param>
+    /// <param name="userParameter">Passed to releaseCallback</param>
+    /// <param name="format">The frames pixels format</param>
+    virtual void AttachAnimation(void* frames, size_t size, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8) = 0;
+    /// <summary>
+    /// Same as the release callback overload, the buffer is moved in and freed once every frame has been uploaded to the GPU.
+    /// Inline, the vector is allocated and freed on the caller side.
+    /// </summary>
+    /// <param name="frames">The frames raw data, stored one after the other</param>
+    /// <param name="frameDurations">How long each frame is shown in milliseconds, 0 is shown 100ms like browsers do. Copied.</param>
+    /// <param name="frameCount">The number of frames</param>
+    /// <param name="width">The frames width</param>
+    /// <param name="height">The frames height</param>
+    /// <param name="format">The frames pixels format</param>
+    inline void AttachAnimation(std::vector<uint8_t>&& frames, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8)
+    {
+        auto buffer = new std::vector<uint8_t>(std::move(frames));
+        AttachAnimation(buffer->data(), buffer->size(), frameDurations, frameCount, width, height, &ReleaseVectorBuffer, buffer, format);
+    }
     /// <summary>
     /// Clears the attached resource. This will NOT delete the resource loaded onto the GPU. Call Unload for that purpose.
     /// </summary>
@@ -78,6 +263,106 @@ public:
     /// If auto loading is enabled, it will load again the resource if its not cleared.
     /// </summary>
     virtual void Unload(bool clearAttachedResource = true) = 0;
+    /// <summary>
+    /// Sets the resource load priority, Normal by default.
+    /// Higher priorities are loaded first, a resource waiting too long is loaded before the others whatever its priority.
+    /// </summary>
+    /// <param name="priority">The load priority</param>
+    virtual void SetPriority(RendererResourcePriority_t priority) = 0;
+    /// <summary>
+    /// Gets the resource load priority.
+    /// </summary>
+    /// <returns>The load priority</returns>
+    virtual RendererResourcePriority_t GetPriority() const = 0;
+    /// <summary>
+    /// Enables progressive loading, disabled by default. A 4 times smaller preview of large RGBA8 or BGRA8 images is made in the background
+    /// and uploaded first, GetResourceId returns it until the full image is loaded.
+    /// Applies to the resources attached after this call.
+    /// </summary>
+    /// <param name="enabled">Enables the preview</param>
+    virtual void SetProgressiveLoad(bool enabled) = 0;
+    /// <summary>
+    /// Gets whether a preview is uploaded before the full image.
+    /// </summary>
+    /// <returns>True if progressive loading is enabled</returns>
+    virtual bool GetProgressiveLoad() const = 0;
+};
+
+/// <summary>
+/// Called on the renderer thread to fill one RGBA8 tile of a tiled resource.
+/// Level 0 is the full image, each next level is half the size of the previous one.
+/// </summary>
+/// <param name="level">The mip level</param>
+/// <param name="tileX">The tile column in this level</param>
+/// <param name="tileY">The tile row in this level</param>
+/// <param name="width">The tile width, smaller than the tile size on the right edge</param>
+/// <param name="height">The tile height, smaller than the tile size on the bottom edge</param>
+/// <param name="pixels">Receives height rows of width RGBA8 pixels</param>
+/// <param name="pitch">The number of bytes between the start of two rows</param>
+/// <param name="userParameter">The user parameter given at creation</param>
+/// <returns>False if the tile is not available yet, it is asked again on a later frame</returns>
+typedef bool (*RendererTileProviderCallback_t)(uint32_t level, uint32_t tileX, uint32_t tileY, uint32_t width, uint32_t height, void* pixels, uint32_t pitch, void* userParameter);
+
+/// <summary>
+/// A textured rectangle to draw, for example with ImGui::GetWindowDrawList()->AddImage.
+/// </summary>
+struct RendererTileQuad_t
+{
+    uint64_t ResourceId;
+    float X0, Y0, X1, Y1;
+    float U0, V0, U1, V1;
+};
+
+/// <summary>
+/// An image too large to be loaded at once, split in tiles filled on demand by a provider.
+/// Only the tiles covering the drawn region, at the level matching the drawn size, are kept in a fixed size tile cache.
+/// The least recently drawn tiles are evicted first. It will be tied to the RendererHook that created it.
+/// </summary>
+class RendererTiledResource_t
+{
+protected:
+    virtual ~RendererTiledResource_t() {}
+
+public:
+    /// <summary>
+    /// Deletes the resource and its tiles.
+    /// </summary>
+    virtual void Delete() = 0;
+    /// <summary>
+    /// Return the full image width.
+    /// </summary>
+    /// <returns></returns>
+    virtual uint32_t Width() const = 0;
+    /// <summary>
+    /// Return the full image height.
+    /// </summary>
+    /// <returns></returns>
+    virtual uint32_t Height() const = 0;
+    /// <summary>
+    /// Return the number of mip levels, the last one fits in a single tile.
+    /// </summary>
+    /// <returns></returns>
+    virtual uint32_t LevelCount() const = 0;
+    /// <summary>
+    /// Computes the quads drawing a region of the image in a screen rectangle. Use it on the same thread as RendererResource_t::GetResourceId.
+    /// The missing tiles are requested, a coarser tile already loaded is drawn in their place until then.
+    /// </summary>
+    /// <param name="x">The screen rectangle left</param>
+    /// <param name="y">The screen rectangle top</param>
+    /// <param name="width">The screen rectangle width</param>
+    /// <param name="height">The screen rectangle height</param>
+    /// <param name="u0">The drawn region left, from 0 to 1</param>
+    /// <param name="v0">The drawn region top, from 0 to 1</param>
+    /// <param name="u1">The drawn region right, from 0 to 1</param>
+    /// <param name="v1">The drawn region bottom, from 0 to 1</param>
+    /// <param name="quads">Receives the quads to draw</param>
+    /// <param name="maxQuads">The quads array size</param>
+    /// <returns>The number of quads written</returns>
+    virtual uint32_t GetDrawQuads(float x, float y, float width, float height, float u0, float v0, float u1, float v1, RendererTileQuad_t* quads, uint32_t maxQuads) = 0;
+    /// <summary>
+    /// Drops every tile, so they are asked again to the provider when drawn. Call it when the image changed.
+    /// </summary>
+    virtual void InvalidateTiles() = 0;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace InGameOverlay {
+
+// XXH64, only meant to find identical buffers.
+class ContentHash_t
+{
+    static constexpr uint64_t Prime1 = 11400714785074694791ULL;
+    static constexpr uint64_t Prime2 = 14029467366897019727ULL;
+    static constexpr uint64_t Prime3 = 1609587929392839161ULL;
+    static constexpr uint64_t Prime4 = 9650029242287828579ULL;
+    static constexpr uint64_t Prime5 = 2870177450012600261ULL;
+
+    static inline uint64_t _Rotl(uint64_t v, int r) { return (v << r) | (v >> (64 - r)); }
+
+    static inline uint64_t _Read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+    static inline uint32_t _Read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+    static inline uint64_t _Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * Prime2;
+        return _Rotl(acc, 31) * Prime1;
+    }
+
+    static inline uint64_t _MergeRound(uint64_t acc, uint64_t value)
+    {
+        acc ^= _Round(0, value);
+        return acc * Prime1 + Prime4;
+    }
+
+public:
+    // Little endian only, like every platform the overlay runs on.
+    static uint64_t Hash(const void* data, size_t size, uint64_t seed = 0)
+    {
+        auto p = reinterpret_cast<const uint8_t*>(data);
+        auto end = p + size;
+        uint64_t h;
+
+        if (size >= 32)
+        {
+            uint64_t v1 = seed + Prime1 + Prime2;
+            uint64_t v2 = seed + Prime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - Prime1;
+
+            for (auto limit = end - 32; p <= limit; p += 32)
+            {
+                v1 = _Round(v1, _Read64(p));
+                v2 = _Round(v2, _Read64(p + 8));
+                v3 = _Round(v3, _Read64(p + 16));
+                v4 = _Round(v4, _Read64(p + 24));
+            }
+
+            h = _Rotl(v1, 1) + _Rotl(v2, 7) + _Rotl(v3, 12) + _Rotl(v4, 18);
+            h = _MergeRound(h, v1);
+            h = _MergeRound(h, v2);
+            h = _MergeRound(h, v3);
+            h = _MergeRound(h, v4);
+        }
+        else
+        {
+            h = seed + Prime5;
+        }
+
+        h += static_cast<uint64_t>(size);
+
+        for (; p + 8 <= end; p += 8)
+            h = _Rotl(h ^ _Round(0, _Read64(p)), 27) * Prime1 + Prime4;
+
+        if (p + 4 <= end)
+        {
+            h = _Rotl(h ^ (static_cast<uint64_t>(_Read32(p)) * Prime1), 23) * Prime2 + Prime3;
+            p += 4;
+        }
+
+        for (; p < end; ++p)
+            h = _Rotl(h ^ (*p * Prime5), 11) * Prime1;
+
+        h ^= h >> 33;
+        h *= Prime2;
+        h ^= h >> 29;
+        h *= Prime3;
+        h ^= h >> 32;
+
+        return h;
+    }
+};
+
+}// namespace InGameOverlay
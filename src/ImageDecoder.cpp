@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageDecoder.h"
+#include "ContentHash.h"
+#include "ResourceCache.h"
+#include "ResourceFormat.h"
+#include "InternalIncludes.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Static so it doesn't clash with an application embedding its own stb_image.
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#define STBI_NO_STDIO
+#define STBI_NO_FAILURE_STRINGS
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_BMP
+#define STBI_ONLY_TGA
+#define STBI_ONLY_GIF
+// DecodedImage_t::Pixels adopts the decoded buffer and frees it with free.
+#define STBI_MALLOC(size) malloc(size)
+#define STBI_REALLOC(pointer, size) realloc(pointer, size)
+#define STBI_FREE(pointer) free(pointer)
+#include "stb_image.h"
+
+namespace InGameOverlay {
+
+static bool ReadFile(std::string const& path, std::vector<uint8_t>& buffer)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    auto size = file.tellg();
+    if (size <= 0)
+        return false;
+
+    buffer.resize(static_cast<size_t>(size));
+    file.seekg(0, std::ios::beg);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(buffer.data()), size));
+}
+
+ImageDecodePool_t::ImageDecodePool_t() :
+    _QueuedJobs(0),
+    _Stop(false),
+    _NextWorker(0)
+{
+}
+
+ImageDecodePool_t::~ImageDecodePool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock(_WakeMutex);
+        _Stop = true;
+    }
+    _WakeCondition.notify_all();
+
+    for (auto& worker : _Workers)
+    {
+        if (worker->Thread.joinable())
+            worker->Thread.join();
+    }
+}
+
+void ImageDecodePool_t::_Start()
+{
+    // Decoding is a background task, leave most of the cores to the application.
+    auto workerCount = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+
+    for (uint32_t i = 0; i < workerCount; ++i)
+        _Workers.emplace_back(new Worker_t);
+
+    for (size_t i = 0; i < _Workers.size(); ++i)
+        _Workers[i]->Thread = std::thread(&ImageDecodePool_t::_WorkerProc, this, i);
+
+    INGAMEOVERLAY_INFO("Started {} image decode threads.", workerCount);
+}
+
+void ImageDecodePool_t::_Submit(std::function<void()> job)
+{
+    std::call_once(_StartFlag, &ImageDecodePool_t::_Start, this);
+
+    auto& worker = *_Workers[_NextWorker.fetch_add(1, std::memory_order_relaxed) % _Workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.JobsMutex);
+        worker.Jobs.emplace_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_WakeMutex);
+        ++_QueuedJobs;
+    }
+    _WakeCondition.notify_one();
+}
+
+bool ImageDecodePool_t::_PopJob(size_t workerIndex, std::function<void()>& job)
+{
+    // Own jobs are taken in submission order, the other workers' are stolen from the back.
+    for (size_t i = 0; i < _Workers.size(); ++i)
+    {
+        auto& worker = *_Workers[(workerIndex + i) % _Workers.size()];
+        std::lock_guard<std::mutex> lock(worker.JobsMutex);
+        if (worker.Jobs.empty())
+            continue;
+
+        if (i == 0)
+        {
+            job = std::move(worker.Jobs.front());
+            worker.Jobs.pop_front();
+        }
+        else
+        {
+            job = std::move(worker.Jobs.back());
+            worker.Jobs.pop_back();
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void ImageDecodePool_t::_WorkerProc(size_t workerIndex)
+{
+    std::function<void()> job;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_WakeMutex);
+            _WakeCondition.wait(lock, [this]() { return _Stop || _QueuedJobs != 0; });
+            if (_Stop)
+                return;
+        }
+
+        if (!_PopJob(workerIndex, job))
+            continue;
+
+        {
+            std::lock_guard<std::mutex> lock(_WakeMutex);
+            --_QueuedJobs;
+        }
+
+        job();
+        job = nullptr;
+    }
+}
+
+void ImageDecodePool_t::_Decode(std::weak_ptr<DecodedImage_t> weakImage)
+{
+    auto image = weakImage.lock();
+    if (image == nullptr)
+        return;
+
+    if (!image->Path.empty() && !ReadFile(image->Path, image->Encoded))
+    {
+        INGAMEOVERLAY_ERROR("Failed to read image file {}.", image->Path);
+        image->Status.store(DecodeStatus_e::Failed, std::memory_order_release);
+        return;
+    }
+
+    std::string cachePath;
+    uint64_t contentHash = 0;
+    if (!image->CacheDirectory.empty())
+    {
+        contentHash = ContentHash_t::Hash(image->Encoded.data(), image->Encoded.size());
+        cachePath = GetResourceCachePath(image->CacheDirectory, contentHash);
+
+        uint32_t cachedWidth, cachedHeight;
+        if (ReadResourceCacheEntry(cachePath, contentHash, cachedWidth, cachedHeight))
+        {
+            std::vector<uint8_t>().swap(image->Encoded);
+            image->CachedPath = std::move(cachePath);
+            image->Width = cachedWidth;
+            image->Height = cachedHeight;
+            image->Status.store(DecodeStatus_e::Decoded, std::memory_order_release);
+            return;
+        }
+    }
+
+    int width = 0, height = 0, frameCount = 1;
+    int* frameDurations = nullptr;
+    stbi_uc* pixels = nullptr;
+    if (image->Encoded.size() <= static_cast<size_t>(INT32_MAX))
+    {
+        // stb_image only loads the first frame of a GIF, unless asked for all of them.
+        if (image->Encoded.size() >= 4 && memcmp(image->Encoded.data(), "GIF8", 4) == 0)
+            pixels = stbi_load_gif_from_memory(image->Encoded.data(), static_cast<int>(image->Encoded.size()), &frameDurations, &width, &height, &frameCount, nullptr, 4);
+        else
+            pixels = stbi_load_from_memory(image->Encoded.data(), static_cast<int>(image->Encoded.size()), &width, &height, nullptr, 4);
+    }
+
+    std::vector<uint8_t>().swap(image->Encoded);
+
+    if (pixels == nullptr)
+    {
+        INGAMEOVERLAY_ERROR("Failed to decode image.");
+        image->Status.store(DecodeStatus_e::Failed, std::memory_order_release);
+        return;
+    }
+
+    image->Pixels.reset(pixels);
+    image->Width = static_cast<uint32_t>(width);
+    image->Height = static_cast<uint32_t>(height);
+    if (frameCount > 1 && frameDurations != nullptr)
+        image->FrameDurations.assign(frameDurations, frameDurations + frameCount);
+
+    stbi_image_free(frameDurations);
+
+    // Animations are decoded every time, the cache entries hold a single image.
+    if (!cachePath.empty() && image->FrameDurations.empty())
+        WriteResourceCacheEntry(cachePath, contentHash, image->Pixels.get(), image->Width, image->Height);
+
+    image->Status.store(DecodeStatus_e::Decoded, std::memory_order_release);
+}
+
+std::shared_ptr<DecodedImage_t> ImageDecodePool_t::DecodeFromMemory(const void* encodedData, size_t encodedSize, std::string const& cacheDirectory)
+{
+    auto image = std::make_shared<DecodedImage_t>();
+    if (encodedData == nullptr || encodedSize == 0)
+    {
+        image->Status.store(DecodeStatus_e::Failed, std::memory_order_relaxed);
+        return image;
+    }
+
+    auto bytes = reinterpret_cast<const uint8_t*>(encodedData);
+    image->Encoded.assign(bytes, bytes + encodedSize);
+    image->CacheDirectory = cacheDirectory;
+
+    std::weak_ptr<DecodedImage_t> weakImage = image;
+    _Submit([weakImage]() { _Decode(weakImage); });
+
+    return image;
+}
+
+std::shared_ptr<DecodedImage_t> ImageDecodePool_t::DecodeFromFile(const char* path, std::string const& cacheDirectory)
+{
+    auto image = std::make_shared<DecodedImage_t>();
+    if (path == nullptr || *path == '\0')
+    {
+        image->Status.store(DecodeStatus_e::Failed, std::memory_order_relaxed);
+        return image;
+    }
+
+    image->Path = path;
+    image->CacheDirectory = cacheDirectory;
+
+    std::weak_ptr<DecodedImage_t> weakImage = image;
+    _Submit([weakImage]() { _Decode(weakImage); });
+
+    return image;
+}
+
+std::shared_ptr<PixelsHash_t> ImageDecodePool_t::HashPixels(const void* pixels, uint32_t width, uint32_t height, RendererResourceFormat_t format, std::shared_ptr<const void> pixelsOwner)
+{
+    auto pixelsHash = std::make_shared<PixelsHash_t>();
+
+    _Submit([pixelsHash, pixels, width, height, format, pixelsOwner]()
+    {
+        std::lock_guard<std::mutex> lock(pixelsHash->Mutex);
+        if (pixelsHash->Cancelled)
+            return;
+
+        uint32_t size[3] = { width, height, static_cast<uint32_t>(format) };
+        auto hash = ContentHash_t::Hash(size, sizeof(size));
+        pixelsHash->Hash = ContentHash_t::Hash(pixels, static_cast<size_t>(GetResourceFormatSize(format, width, height)), hash);
+        pixelsHash->Done.store(true, std::memory_order_release);
+    });
+
+    return pixelsHash;
+}
+
+void ImageDecodePool_t::CancelHash(PixelsHash_t& pixelsHash)
+{
+    std::lock_guard<std::mutex> lock(pixelsHash.Mutex);
+    pixelsHash.Cancelled = true;
+}
+
+void ImageDecodePool_t::_Downscale(const uint8_t* pixels, uint32_t width, uint32_t height, ImagePreview_t& preview)
+{
+    preview.Width = width / PreviewScale;
+    preview.Height = height / PreviewScale;
+    preview.Pixels.resize(size_t(preview.Width) * size_t(preview.Height) * 4);
+
+    const size_t rowSize = size_t(preview.Width) * 4;
+    const uint32_t blockSize = PreviewScale * PreviewScale;
+    std::vector<uint32_t> sums(rowSize);
+
+    for (uint32_t y = 0; y < preview.Height; ++y)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+
+        // Channels are summed independently over contiguous memory, so the compiler can vectorize the loops.
+        for (uint32_t row = 0; row < PreviewScale; ++row)
+        {
+            const uint8_t* src = pixels + (size_t(y) * PreviewScale + row) * size_t(width) * 4;
+            for (size_t x = 0; x < rowSize; x += 4)
+            {
+                for (uint32_t i = 0; i < PreviewScale; ++i, src += 4)
+                {
+                    sums[x    ] += src[0];
+                    sums[x + 1] += src[1];
+                    sums[x + 2] += src[2];
+                    sums[x + 3] += src[3];
+                }
+            }
+        }
+
+        uint8_t* dst = preview.Pixels.data() + size_t(y) * rowSize;
+        for (size_t i = 0; i < rowSize; ++i)
+            dst[i] = static_cast<uint8_t>(sums[i] / blockSize);
+    }
+}
+
+std::shared_ptr<ImagePreview_t> ImageDecodePool_t::MakePreview(const void* pixels, uint32_t width, uint32_t height, std::shared_ptr<const void> pixelsOwner)
+{
+    if (pixels == nullptr || width < PreviewMinimumSize || height < PreviewMinimumSize)
+        return nullptr;
+
+    auto preview = std::make_shared<ImagePreview_t>();
+
+    _Submit([preview, pixels, width, height, pixelsOwner]()
+    {
+        std::lock_guard<std::mutex> lock(preview->Mutex);
+        if (preview->Cancelled)
+            return;
+
+        _Downscale(static_cast<const uint8_t*>(pixels), width, height, *preview);
+        preview->Done.store(true, std::memory_order_release);
+    });
+
+    return preview;
+}
+
+void ImageDecodePool_t::CancelPreview(ImagePreview_t& preview)
+{
+    std::lock_guard<std::mutex> lock(preview.Mutex);
+    preview.Cancelled = true;
+}
+
+}// namespace InGameOverlay
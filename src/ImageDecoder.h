@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <InGameOverlay/RendererResource.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace InGameOverlay {
+
+enum class DecodeStatus_e
+{
+    Pending,
+    Decoded,
+    Failed,
+};
+
+struct DecodedImage_t
+{
+    std::atomic<DecodeStatus_e> Status{ DecodeStatus_e::Pending };
+    // Input, released once the decode is done.
+    std::vector<uint8_t> Encoded;
+    std::string Path;
+    // Where the decoded pixels are looked up and stored, empty to decode every time.
+    std::string CacheDirectory;
+    // Output, only readable once Status is Decoded. The stb_image buffer, freed with free like stbi_image_free does.
+    std::unique_ptr<uint8_t, void(*)(void*)> Pixels{ nullptr, &free };
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    // Milliseconds each frame of an animated GIF is shown, its frames are stored one after the other in Pixels. Empty for still images.
+    std::vector<uint32_t> FrameDurations;
+    // Set instead of Pixels when the pixels were found in the cache, they are mapped from this file.
+    std::string CachedPath;
+};
+
+struct PixelsHash_t
+{
+    // Held while hashing, so cancelling waits until the pixels are not read anymore.
+    std::mutex Mutex;
+    bool Cancelled = false;
+    std::atomic<bool> Done{ false };
+    uint64_t Hash = 0;
+};
+
+struct ImagePreview_t
+{
+    // Held while downscaling, so cancelling waits until the pixels are not read anymore.
+    std::mutex Mutex;
+    bool Cancelled = false;
+    std::atomic<bool> Done{ false };
+    std::vector<uint8_t> Pixels;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+};
+
+// Small work stealing pool decoding PNG/JPEG/BMP/TGA/GIF images to RGBA, hashing pixels and downscaling previews.
+// The threads are started on the first decode request.
+// A job only keeps a weak reference on its image, dropping the image cancels its decode.
+class ImageDecodePool_t
+{
+    struct Worker_t
+    {
+        std::mutex JobsMutex;
+        std::deque<std::function<void()>> Jobs;
+        std::thread Thread;
+    };
+
+    std::vector<std::unique_ptr<Worker_t>> _Workers;
+    std::once_flag _StartFlag;
+    std::mutex _WakeMutex;
+    std::condition_variable _WakeCondition;
+    size_t _QueuedJobs;
+    bool _Stop;
+    std::atomic<uint32_t> _NextWorker;
+
+    void _Start();
+    void _Submit(std::function<void()> job);
+    bool _PopJob(size_t workerIndex, std::function<void()>& job);
+    void _WorkerProc(size_t workerIndex);
+
+    static void _Decode(std::weak_ptr<DecodedImage_t> weakImage);
+    static void _Downscale(const uint8_t* pixels, uint32_t width, uint32_t height, ImagePreview_t& preview);
+
+public:
+    ImageDecodePool_t();
+    ~ImageDecodePool_t();
+
+    ImageDecodePool_t(ImageDecodePool_t const&) = delete;
+    ImageDecodePool_t& operator=(ImageDecodePool_t const&) = delete;
+
+    // The encoded buffer is copied, it can be freed as soon as this returns.
+    // Still images are looked up in and added to cacheDirectory, unless it is empty.
+    std::shared_ptr<DecodedImage_t> DecodeFromMemory(const void* encodedData, size_t encodedSize, std::string const& cacheDirectory);
+
+    // The file is read by the pool too.
+    std::shared_ptr<DecodedImage_t> DecodeFromFile(const char* path, std::string const& cacheDirectory);
+
+    // Hashes pixels with their size and format. The pixels must stay valid until the hash is done or cancelled.
+    std::shared_ptr<PixelsHash_t> HashPixels(const void* pixels, uint32_t width, uint32_t height, RendererResourceFormat_t format, std::shared_ptr<const void> pixelsOwner);
+
+    // Blocks until the pixels are not used by the hash job anymore.
+    static void CancelHash(PixelsHash_t& pixelsHash);
+
+    // Each side is divided by PreviewScale, images smaller than PreviewMinimumSize on any side get no preview.
+    static constexpr uint32_t PreviewScale = 4;
+    static constexpr uint32_t PreviewMinimumSize = 128;
+
+    // Box filters RGBA pixels down to a preview. The pixels must stay valid until the preview is done or cancelled.
+    std::shared_ptr<ImagePreview_t> MakePreview(const void* pixels, uint32_t width, uint32_t height, std::shared_ptr<const void> pixelsOwner);
+
+    // Blocks until the pixels are not used by the preview job anymore.
+    static void CancelPreview(ImagePreview_t& preview);
+};
+
+}// namespace InGameOverlay
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "KTX2.h"
+#include "InternalIncludes.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace InGameOverlay {
+
+static constexpr uint8_t KTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct KTX2Header_t
+{
+    uint8_t Identifier[12];
+    uint32_t VkFormat;
+    uint32_t TypeSize;
+    uint32_t PixelWidth;
+    uint32_t PixelHeight;
+    uint32_t PixelDepth;
+    uint32_t LayerCount;
+    uint32_t FaceCount;
+    uint32_t LevelCount;
+    uint32_t SupercompressionScheme;
+    uint32_t DfdByteOffset;
+    uint32_t DfdByteLength;
+    uint32_t KvdByteOffset;
+    uint32_t KvdByteLength;
+    uint64_t SgdByteOffset;
+    uint64_t SgdByteLength;
+};
+static_assert(sizeof(KTX2Header_t) == 80, "The level index starts at byte 80.");
+
+struct KTX2LevelIndex_t
+{
+    uint64_t ByteOffset;
+    uint64_t ByteLength;
+    uint64_t UncompressedByteLength;
+};
+
+// The container stores a VkFormat, whatever the renderer.
+static bool VkFormatToResourceFormat(uint32_t vkFormat, RendererResourceFormat_t& format)
+{
+    switch (vkFormat)
+    {
+        case 4  : format = RendererResourceFormat_t::RGB565   ; return true; // VK_FORMAT_R5G6B5_UNORM_PACK16
+        case 9  :                                                            // VK_FORMAT_R8_UNORM
+        case 15 : format = RendererResourceFormat_t::R8       ; return true; // VK_FORMAT_R8_SRGB
+        case 16 :                                                            // VK_FORMAT_R8G8_UNORM
+        case 22 : format = RendererResourceFormat_t::RG8      ; return true; // VK_FORMAT_R8G8_SRGB
+        case 37 :                                                            // VK_FORMAT_R8G8B8A8_UNORM
+        case 43 : format = RendererResourceFormat_t::RGBA8    ; return true; // VK_FORMAT_R8G8B8A8_SRGB
+        case 44 :                                                            // VK_FORMAT_B8G8R8A8_UNORM
+        case 50 : format = RendererResourceFormat_t::BGRA8    ; return true; // VK_FORMAT_B8G8R8A8_SRGB
+        case 97 : format = RendererResourceFormat_t::RGBA16F  ; return true; // VK_FORMAT_R16G16B16A16_SFLOAT
+        case 131:                                                            // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case 132:                                                            // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+        case 133:                                                            // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case 134: format = RendererResourceFormat_t::BC1      ; return true; // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+        case 137:                                                            // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138: format = RendererResourceFormat_t::BC3      ; return true; // VK_FORMAT_BC3_SRGB_BLOCK
+        case 139: format = RendererResourceFormat_t::BC4      ; return true; // VK_FORMAT_BC4_UNORM_BLOCK
+        case 141: format = RendererResourceFormat_t::BC5      ; return true; // VK_FORMAT_BC5_UNORM_BLOCK
+        case 145:                                                            // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146: format = RendererResourceFormat_t::BC7      ; return true; // VK_FORMAT_BC7_SRGB_BLOCK
+        case 147:                                                            // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        case 148: format = RendererResourceFormat_t::ETC2RGB8 ; return true; // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+        case 151:                                                            // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        case 152: format = RendererResourceFormat_t::ETC2RGBA8; return true; // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+        default : return false;
+    }
+}
+
+bool ParseKTX2(const void* data, size_t size, RendererResourceFormat_t& format, std::vector<RendererTextureLevel_t>& levels)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    KTX2Header_t header;
+    if (data == nullptr || size < sizeof(header))
+        return false;
+
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.Identifier, KTX2Identifier, sizeof(KTX2Identifier)) != 0)
+    {
+        INGAMEOVERLAY_ERROR("Not a KTX2 container.");
+        return false;
+    }
+
+    if (header.PixelWidth == 0 || header.PixelHeight == 0 || header.PixelDepth != 0 || header.LayerCount != 0 || header.FaceCount != 1)
+    {
+        INGAMEOVERLAY_ERROR("Only 2D KTX2 images are supported.");
+        return false;
+    }
+
+    if (header.SupercompressionScheme != 0)
+    {
+        INGAMEOVERLAY_ERROR("KTX2 supercompression {} is not supported.", header.SupercompressionScheme);
+        return false;
+    }
+
+    if (!VkFormatToResourceFormat(header.VkFormat, format))
+    {
+        INGAMEOVERLAY_ERROR("KTX2 format {} is not supported.", header.VkFormat);
+        return false;
+    }
+
+    // 0 asks the loader to generate the mip chain, only the first level is loaded then.
+    const uint32_t levelCount = std::max(header.LevelCount, 1u);
+    if (levelCount > 32 || (size - sizeof(header)) / sizeof(KTX2LevelIndex_t) < levelCount)
+        return false;
+
+    levels.clear();
+    levels.reserve(levelCount);
+    for (uint32_t i = 0; i < levelCount; ++i)
+    {
+        KTX2LevelIndex_t levelIndex;
+        memcpy(&levelIndex, bytes + sizeof(header) + i * sizeof(levelIndex), sizeof(levelIndex));
+
+        const uint32_t width = std::max(header.PixelWidth >> i, 1u);
+        const uint32_t height = std::max(header.PixelHeight >> i, 1u);
+        if (levelIndex.ByteLength != GetResourceFormatSize(format, width, height) || levelIndex.ByteOffset > size || size - levelIndex.ByteOffset < levelIndex.ByteLength)
+        {
+            INGAMEOVERLAY_ERROR("Invalid KTX2 level {}.", i);
+            return false;
+        }
+
+        levels.emplace_back(RendererTextureLevel_t{ bytes + levelIndex.ByteOffset, width, height });
+    }
+
+    return true;
+}
+
+}// namespace InGameOverlay
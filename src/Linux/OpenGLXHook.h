@@ -39,10 +39,12 @@ private:
     OverlayHookState _HookState;
     Display *_Display;
     //GLXContext _Context;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
+    // Converts the planar YUV resources to RGBA on the GPU, 0 until the first one is loaded.
+    uint32_t _YUVProgram;
+    int32_t _YUVInterleavedLocation;
+    bool _YUVProgramFailed;
 
     // Functions
     OpenGLXHook_t();
@@ -50,6 +52,11 @@ private:
     void _ResetRenderState(OverlayHookState state);
     void _PrepareForOverlay(Display* display, GLXDrawable drawable);
     void _LoadResources();
+    virtual bool _SupportsResourceFormat(RendererResourceFormat_t format);
+    virtual bool _SupportsResourceMipLevels();
+    bool _CreateYUVProgram();
+    void _DestroyYUVProgram();
+    bool _ConvertYUVTexture(uint32_t texture, const void* data, uint32_t width, uint32_t height, RendererResourceFormat_t format);
     void _ReleaseResources();
     void _HandleScreenshot();
 
@@ -66,15 +73,16 @@ public:
     virtual bool StartHook(std::function<void()> key_combination_callback, ToggleKey toggleKeys[], int toggleKeysCount, /*ImFontAtlas* */ void* imgui_font_atlas = nullptr);
     virtual void HideAppInputs(bool hide);
     virtual void HideOverlayInputs(bool hide);
+    virtual bool SetDedicatedInputThread(bool enabled);
+    virtual bool SetCoalesceScrollEvents(bool coalesce);
+    virtual uint64_t GetCoalescedInputEventCount();
     virtual bool IsStarted();
     static OpenGLXHook_t* Inst();
     virtual const char* GetLibraryName() const;
     virtual RendererHookType_t GetRendererHookType() const;
     void LoadFunctions(decltype(::glXSwapBuffers)* pfnglXSwapBuffers);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
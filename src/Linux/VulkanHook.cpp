@@ -92,6 +92,61 @@ static InGameOverlay::ScreenshotDataFormat_t RendererFormatToScreenshotFormat(Vk
   }
 }
 
+// Single channel formats are spread with the view swizzle, the shader always samples RGBA.
+static VkFormat ResourceFormatToVulkanFormat(RendererResourceFormat_t format, VkComponentMapping& components) {
+  components = {VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY,
+                VK_COMPONENT_SWIZZLE_IDENTITY};
+
+  switch (format) {
+    case RendererResourceFormat_t::BGRA8:
+      return VK_FORMAT_B8G8R8A8_UNORM;
+
+    case RendererResourceFormat_t::R8:
+      components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+      return VK_FORMAT_R8_UNORM;
+
+    case RendererResourceFormat_t::A8:
+      components = {VK_COMPONENT_SWIZZLE_ONE, VK_COMPONENT_SWIZZLE_ONE, VK_COMPONENT_SWIZZLE_ONE, VK_COMPONENT_SWIZZLE_R};
+      return VK_FORMAT_R8_UNORM;
+
+    case RendererResourceFormat_t::RG8:
+      components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G};
+      return VK_FORMAT_R8G8_UNORM;
+
+    case RendererResourceFormat_t::RGB565:
+      return VK_FORMAT_R5G6B5_UNORM_PACK16;
+
+    case RendererResourceFormat_t::RGBA16F:
+      return VK_FORMAT_R16G16B16A16_SFLOAT;
+
+    case RendererResourceFormat_t::BC1:
+      return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::BC3:
+      return VK_FORMAT_BC3_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::BC4:
+      components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+      return VK_FORMAT_BC4_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::BC5:
+      components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G};
+      return VK_FORMAT_BC5_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::BC7:
+      return VK_FORMAT_BC7_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::ETC2RGB8:
+      return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+
+    case RendererResourceFormat_t::ETC2RGBA8:
+      return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+
+    default:
+      return VK_FORMAT_R8G8B8A8_UNORM;
+  }
+}
+
 bool VulkanHook_t::StartHook(std::function<void()> keyCombinationCallback, ToggleKey toggleKeys[], int toggleKeysCount,
                              /*ImFontAtlas* */ void* imguiFontAtlas) {
   if (!_Hooked) {
@@ -136,6 +191,19 @@ void VulkanHook_t::HideOverlayInputs(bool hide) {
     X11Hook_t::Inst()->HideOverlayInputs(hide);
 }
 
+bool VulkanHook_t::SetDedicatedInputThread(bool enabled) {
+  return X11Hook_t::Inst()->SetDedicatedInputThread(enabled);
+}
+
+bool VulkanHook_t::SetCoalesceScrollEvents(bool coalesce) {
+  X11Hook_t::Inst()->SetCoalesceScrollEvents(coalesce);
+  return true;
+}
+
+uint64_t VulkanHook_t::GetCoalescedInputEventCount() {
+  return X11Hook_t::Inst()->GetCoalescedEventCount();
+}
+
 bool VulkanHook_t::IsStarted() {
   return _Hooked;
 }
@@ -181,7 +249,52 @@ VulkanHook_t::VulkanDescriptorSet_t VulkanHook_t::_GetFreeDescriptorSetFromPool(
   return descriptorSet;
 }
 
+void VulkanHook_t::_ReserveDescriptorSets(uint32_t count) {
+  std::vector<VkDescriptorSetLayout> layouts;
+  std::vector<VkDescriptorSet> descriptorSets;
+
+  uint32_t poolIndex = 0;
+  while (count > 0) {
+    while (poolIndex < _DescriptorsPools.size() && _DescriptorsPools[poolIndex].UsedDescriptors >= MaxDescriptorCountPerPool)
+      ++poolIndex;
+
+    if (poolIndex == _DescriptorsPools.size() && !_AllocDescriptorPool())
+      return;
+
+    auto& descriptorsPool = _DescriptorsPools[poolIndex];
+    const uint32_t available = MaxDescriptorCountPerPool - descriptorsPool.UsedDescriptors;
+    const uint32_t setCount = count < available ? count : available;
+
+    layouts.assign(setCount, _VulkanImageDescriptorSetLayout);
+    descriptorSets.resize(setCount);
+
+    // Every set the pool can still give in a single call.
+    VkDescriptorSetAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptorsPool.DescriptorPool;
+    alloc_info.descriptorSetCount = setCount;
+    alloc_info.pSetLayouts = layouts.data();
+    if (_vkAllocateDescriptorSets(_VulkanDevice, &alloc_info, descriptorSets.data()) != VK_SUCCESS)
+      return;
+
+    for (auto vulkanDescriptorSet : descriptorSets)
+      _ReservedDescriptorSets.emplace_back(VulkanDescriptorSet_t{
+          vulkanDescriptorSet, MakeImageDescriptorId(poolIndex, descriptorsPool.UsedDescriptors++)});
+
+    count -= setCount;
+  }
+}
+
 VulkanHook_t::VulkanDescriptorSet_t VulkanHook_t::_GetFreeDescriptorSet() {
+  if (_ReservedDescriptorSets.empty())
+    _ReserveDescriptorSets(_DescriptorSetReservations.exchange(0, std::memory_order_relaxed));
+
+  if (!_ReservedDescriptorSets.empty()) {
+    auto descriptorSet = _ReservedDescriptorSets.back();
+    _ReservedDescriptorSets.pop_back();
+    return descriptorSet;
+  }
+
   for (uint32_t poolIndex = 0; poolIndex < _DescriptorsPools.size(); ++poolIndex) {
     if (_DescriptorsPools[poolIndex].UsedDescriptors < MaxDescriptorCountPerPool)
       return _GetFreeDescriptorSetFromPool(poolIndex);
@@ -193,6 +306,14 @@ VulkanHook_t::VulkanDescriptorSet_t VulkanHook_t::_GetFreeDescriptorSet() {
   return _GetFreeDescriptorSetFromPool(_DescriptorsPools.size() - 1);
 }
 
+void VulkanHook_t::_ReserveImageResources(uint32_t count) {
+  // Never more than a pool ahead, the sets are allocated whether the resources get loaded or not.
+  uint32_t reservations = _DescriptorSetReservations.load(std::memory_order_relaxed);
+  while (!_DescriptorSetReservations.compare_exchange_weak(
+      reservations, reservations + std::min(count, MaxDescriptorCountPerPool - reservations), std::memory_order_relaxed)) {
+  }
+}
+
 void VulkanHook_t::_ReleaseDescriptor(VulkanDescriptorSet_t descriptorSet) {
   auto& pool = _DescriptorsPools[GetImageDescriptorPool(descriptorSet.DescriptorPoolId)];
 
@@ -200,11 +321,46 @@ void VulkanHook_t::_ReleaseDescriptor(VulkanDescriptorSet_t descriptorSet) {
   --pool.UsedDescriptors;
 }
 
+bool VulkanHook_t::_SupportsResourceFormat(RendererResourceFormat_t format) {
+  // A VkSamplerYcbcrConversion needs an immutable sampler in the descriptor set layout, the ImGui pipeline can't
+  // sample it.
+  if (IsResourceFormatPlanar(format))
+    return false;
+
+  // The uncompressed ones are mandatory sampled image formats.
+  if (!IsResourceFormatCompressed(format))
+    return true;
+
+  if (_VulkanPhysicalDevice == VK_NULL_HANDLE || _vkGetPhysicalDeviceFormatProperties == nullptr)
+    return false;
+
+  VkComponentMapping components;
+  VkFormatProperties properties{};
+  _vkGetPhysicalDeviceFormatProperties(_VulkanPhysicalDevice, ResourceFormatToVulkanFormat(format, components), &properties);
+  return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+bool VulkanHook_t::_SupportsResourceMipLevels() {
+  return true;
+}
+
+bool VulkanHook_t::_GetDescriptorUsage(uint32_t& used, uint32_t& capacity) {
+  used = 0;
+  for (auto const& pool : _DescriptorsPools)
+    used += pool.UsedDescriptors;
+
+  // Reserved sets are allocated but not used yet.
+  used -= static_cast<uint32_t>(_ReservedDescriptorSets.size());
+  capacity = static_cast<uint32_t>(_DescriptorsPools.size()) * MaxDescriptorCountPerPool;
+  return true;
+}
+
 void VulkanHook_t::_DestroyDescriptorPools() {
   for (auto& pool : _DescriptorsPools)
     _vkDestroyDescriptorPool(_VulkanDevice, pool.DescriptorPool, _VulkanAllocationCallbacks);
 
   _DescriptorsPools.clear();
+  _ReservedDescriptorSets.clear();
 }
 
 void VulkanHook_t::_CreateImageTexture(VkDescriptorSet descriptorSet, VkImageView imageView,
@@ -367,7 +523,7 @@ void VulkanHook_t::_ResetRenderState(OverlayHookState state) {
       X11Hook_t::Inst()->ResetRenderState(state);
       ImGui::DestroyContext();
 
-      _ImageResources.clear();
+      _ClearImageResources();
 
       _FreeVulkanRessources();
 
@@ -392,6 +548,7 @@ void VulkanHook_t::_FreeVulkanRessources() {
   _DestroyImageDevices();
 
   _DestroyDescriptorPools();
+  _DestroyStagingPages();
 
   _VulkanQueue = nullptr;
   _VulkanDevice = nullptr;
@@ -401,16 +558,27 @@ bool VulkanHook_t::_CreateVulkanInstance() {
   _vkGetInstanceProcAddr = (decltype(::vkGetInstanceProcAddr)*)_VulkanLoader("vkGetInstanceProcAddr");
   _vkCreateInstance = (decltype(::vkCreateInstance)*)_VulkanLoader("vkCreateInstance");
   _vkDestroyInstance = (decltype(::vkDestroyInstance)*)_VulkanLoader("vkDestroyInstance");
+  auto vkEnumerateInstanceExtensionProperties = (decltype(::vkEnumerateInstanceExtensionProperties)*)_VulkanLoader("vkEnumerateInstanceExtensionProperties");
 
   // Create Vulkan Instance
   {
     _VulkanInstance = nullptr;
     VkInstanceCreateInfo createInfo = {};
-    constexpr const char* instance_extension = VK_KHR_SURFACE_EXTENSION_NAME;
+    std::vector<const char*> instanceExtensions{VK_KHR_SURFACE_EXTENSION_NAME};
+
+    // Needed to query VK_EXT_memory_budget.
+    if (vkEnumerateInstanceExtensionProperties != nullptr) {
+      uint32_t count = 0;
+      vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+      std::vector<VkExtensionProperties> extensionProperties(count);
+      vkEnumerateInstanceExtensionProperties(nullptr, &count, extensionProperties.data());
+      if (IsVulkanExtensionAvailable(extensionProperties, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+        instanceExtensions.emplace_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+    }
 
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-    createInfo.enabledExtensionCount = 1;
-    createInfo.ppEnabledExtensionNames = &instance_extension;
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(instanceExtensions.size());
+    createInfo.ppEnabledExtensionNames = instanceExtensions.data();
 
     // Create Vulkan Instance without any debug feature
     _vkCreateInstance(&createInfo, _VulkanAllocationCallbacks, &_VulkanInstance);
@@ -478,7 +646,9 @@ bool VulkanHook_t::_CreateVulkanInstance() {
   LOAD_VULKAN_FUNCTION(vkEnumeratePhysicalDevices);
   LOAD_VULKAN_FUNCTION(vkGetPhysicalDeviceSurfaceFormatsKHR);
   LOAD_VULKAN_FUNCTION(vkGetPhysicalDeviceProperties);
+  LOAD_VULKAN_FUNCTION(vkGetPhysicalDeviceFormatProperties);
   LOAD_VULKAN_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties);
+  LOAD_VULKAN_FUNCTION(vkGetPhysicalDeviceMemoryProperties2KHR);
 #undef LOAD_VULKAN_FUNCTION
 
   if (!_GetPhysicalDevice()) {
@@ -556,6 +726,13 @@ bool VulkanHook_t::_GetPhysicalDevice() {
     return false;
   }
 
+  uint32_t count;
+  _vkEnumerateDeviceExtensionProperties(_VulkanPhysicalDevice, nullptr, &count, nullptr);
+  extensionProperties.resize(count);
+  _vkEnumerateDeviceExtensionProperties(_VulkanPhysicalDevice, nullptr, &count, extensionProperties.data());
+  _VulkanMemoryBudgetSupported = _vkGetPhysicalDeviceMemoryProperties2KHR != nullptr &&
+                                 IsVulkanExtensionAvailable(extensionProperties, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
   return true;
 }
 
@@ -810,6 +987,11 @@ void VulkanHook_t::_PrepareForOverlay(VkQueue queue, const VkPresentInfoKHR* pPr
 
     ImGui_ImplVulkan_Init(&init_info);
 
+    {
+      std::lock_guard<std::mutex> lock(_StagingMutex);
+      _StagingDevice = _VulkanDevice;
+    }
+
     _ResetRenderState(OverlayHookState::Ready);
   }
 
@@ -854,7 +1036,7 @@ void VulkanHook_t::_PrepareForOverlay(VkQueue queue, const VkPresentInfoKHR* pPr
       ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
     }
 
-    ++_CurrentFrame;
+    _BeginFrame();
     ImGui::NewFrame();
 
     OverlayProc();
@@ -930,33 +1112,49 @@ void VulkanHook_t::_LoadResources() {
   VkResult result;
 
   struct ValidTexture_t {
-    std::shared_ptr<VulkanTexture_t> Resource;
-    const void* Data;
+    VulkanTexture_t* Resource;
+    std::shared_ptr<const void> DataOwner;
     uint32_t Width;
     uint32_t Height;
-    VkDeviceSize Offset;
-    VkDeviceSize Size;
+    RendererResourceFormat_t Format;
+    VkBuffer SourceBuffer;
+    VkDeviceSize SourceOffset;
+    // The full size level first, and where each level starts in its buffer.
+    std::vector<RendererTextureLevel_t> Levels;
+    std::vector<VkDeviceSize> Offsets;
   };
 
   std::vector<ValidTexture_t> validResources;
 
-  const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-  for (size_t i = 0; i < loadParameterCount; ++i) {
-    auto& param = _ImageResourcesToLoad[i];
-
-    auto r = param.Resource.lock();
-    if (!r)
+  RendererTextureLoadParameter_t param;
+  for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i) {
+    auto r = GetImageResource(param.Resource);
+    if (r == nullptr)
       continue;
 
     ValidTexture_t t{};
-    t.Resource = std::static_pointer_cast<VulkanTexture_t>(r);
-    t.Data = param.Data;
+    t.Resource = static_cast<VulkanTexture_t*>(r);
+    t.DataOwner = std::move(param.DataOwner);
     t.Width = param.Width;
     t.Height = param.Height;
-    t.Size = t.Width * t.Height * 4;
+    t.Format = param.Format;
+    t.Levels.reserve(1 + param.MipLevels.size());
+    t.Levels.emplace_back(RendererTextureLevel_t{param.Data, param.Width, param.Height});
+    t.Levels.insert(t.Levels.end(), param.MipLevels.begin(), param.MipLevels.end());
+    if (param.StagingBuffer != nullptr && param.StagingBuffer->RendererMemory) {
+      // Its memory went away with the previous device, the resource has to write it again.
+      // Dropping the load releases the pixels, the resource has nothing to load anymore until they are written again.
+      auto stagingBuffer = static_cast<VulkanStagingBuffer_t*>(param.StagingBuffer);
+      if (stagingBuffer->DeviceGeneration != _VulkanDeviceGeneration) {
+        r->LoadStatus = RendererTextureStatus_e::NotLoaded;
+        continue;
+      }
+
+      t.SourceBuffer = stagingBuffer->Buffer;
+      t.SourceOffset = stagingBuffer->Offset;
+    }
 
-    validResources.push_back(t);
+    validResources.push_back(std::move(t));
   }
 
   if (validResources.empty())
@@ -965,14 +1163,23 @@ void VulkanHook_t::_LoadResources() {
   VkDeviceSize totalUploadSize = 0;
 
   for (auto& v : validResources) {
-    v.Offset = totalUploadSize;
-    totalUploadSize += v.Size;
+    // Already in a mapped staging page, no need to copy it again.
+    if (v.SourceBuffer != VK_NULL_HANDLE) {
+      v.Offsets.assign(1, v.SourceOffset);
+      continue;
+    }
+
+    for (auto const& level : v.Levels) {
+      // Copies must start on a texel block boundary, 16 fits every format.
+      v.Offsets.emplace_back((totalUploadSize + 15) & ~VkDeviceSize(15));
+      totalUploadSize = v.Offsets.back() + GetResourceFormatSize(v.Format, level.Width, level.Height);
+    }
   }
 
   VkBuffer uploadBuffer = VK_NULL_HANDLE;
   VkDeviceMemory uploadBufferMemory = VK_NULL_HANDLE;
 
-  {
+  if (totalUploadSize != 0) {
     VkBufferCreateInfo buffer_info{};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     buffer_info.size = totalUploadSize;
@@ -996,12 +1203,18 @@ void VulkanHook_t::_LoadResources() {
     _vkBindBufferMemory(_VulkanDevice, uploadBuffer, uploadBufferMemory, 0);
   }
 
-  {
+  if (totalUploadSize != 0) {
     uint8_t* map = nullptr;
     _vkMapMemory(_VulkanDevice, uploadBufferMemory, 0, totalUploadSize, 0, (void**)&map);
 
-    for (auto& v : validResources)
-      memcpy(map + v.Offset, v.Data, v.Size);
+    for (auto& v : validResources) {
+      if (v.SourceBuffer != VK_NULL_HANDLE)
+        continue;
+
+      for (size_t level = 0; level < v.Levels.size(); ++level)
+        memcpy(map + v.Offsets[level], v.Levels[level].Data,
+               GetResourceFormatSize(v.Format, v.Levels[level].Width, v.Levels[level].Height));
+    }
 
     _vkUnmapMemory(_VulkanDevice, uploadBufferMemory);
   }
@@ -1018,13 +1231,15 @@ void VulkanHook_t::_LoadResources() {
     VkImage image = VK_NULL_HANDLE;
     VkImageView view = VK_NULL_HANDLE;
     VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkComponentMapping components;
+    const VkFormat format = ResourceFormatToVulkanFormat(tex.Format, components);
 
     VkImageCreateInfo info{};
     info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     info.imageType = VK_IMAGE_TYPE_2D;
-    info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    info.format = format;
     info.extent = {tex.Width, tex.Height, 1};
-    info.mipLevels = 1;
+    info.mipLevels = static_cast<uint32_t>(tex.Levels.size());
     info.arrayLayers = 1;
     info.samples = VK_SAMPLE_COUNT_1_BIT;
     info.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -1047,9 +1262,10 @@ void VulkanHook_t::_LoadResources() {
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+    viewInfo.format = format;
+    viewInfo.components = components;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = static_cast<uint32_t>(tex.Levels.size());
     viewInfo.subresourceRange.layerCount = 1;
 
     _vkCreateImageView(_VulkanDevice, &viewInfo, _VulkanAllocationCallbacks, &view);
@@ -1063,20 +1279,25 @@ void VulkanHook_t::_LoadResources() {
     barrier1.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier1.image = image;
     barrier1.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier1.subresourceRange.levelCount = 1;
+    barrier1.subresourceRange.levelCount = static_cast<uint32_t>(tex.Levels.size());
     barrier1.subresourceRange.layerCount = 1;
 
     _vkCmdPipelineBarrier(_VulkanImageCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
                           0, 0, nullptr, 0, nullptr, 1, &barrier1);
 
-    VkBufferImageCopy region{};
-    region.bufferOffset = tex.Offset;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.layerCount = 1;
-    region.imageExtent = {tex.Width, tex.Height, 1};
+    // One region per level, all copied by a single command.
+    std::vector<VkBufferImageCopy> regions(tex.Levels.size());
+    for (size_t level = 0; level < regions.size(); ++level) {
+      regions[level].bufferOffset = tex.Offsets[level];
+      regions[level].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      regions[level].imageSubresource.mipLevel = static_cast<uint32_t>(level);
+      regions[level].imageSubresource.layerCount = 1;
+      regions[level].imageExtent = {tex.Levels[level].Width, tex.Levels[level].Height, 1};
+    }
 
-    _vkCmdCopyBufferToImage(_VulkanImageCommandBuffer, uploadBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                            &region);
+    _vkCmdCopyBufferToImage(_VulkanImageCommandBuffer,
+                            tex.SourceBuffer != VK_NULL_HANDLE ? tex.SourceBuffer : uploadBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            static_cast<uint32_t>(regions.size()), regions.data());
 
     VkImageMemoryBarrier barrier2{};
     barrier2.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -1093,7 +1314,7 @@ void VulkanHook_t::_LoadResources() {
     tex.Resource->VulkanImage = image;
     tex.Resource->VulkanImageMemory = memory;
     tex.Resource->VulkanImageView = view;
-    tex.Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+    _ImageResourceLoaded(tex.Resource);
   }
 
   _vkEndCommandBuffer(_VulkanImageCommandBuffer);
@@ -1109,11 +1330,40 @@ void VulkanHook_t::_LoadResources() {
 
   _vkDestroyBuffer(_VulkanDevice, uploadBuffer, _VulkanAllocationCallbacks);
   _vkFreeMemory(_VulkanDevice, uploadBufferMemory, _VulkanAllocationCallbacks);
+}
+
+bool VulkanHook_t::_GetTextureMemoryHeadroom(uint64_t& headroom) {
+  if (!_VulkanMemoryBudgetSupported)
+    return false;
+
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudget{};
+  memoryBudget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+  VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+  memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+  memoryProperties.pNext = &memoryBudget;
+
+  _vkGetPhysicalDeviceMemoryProperties2KHR(_VulkanPhysicalDevice, &memoryProperties);
+
+  // Textures are allocated in device local memory, keep under the tightest device local heap.
+  bool found = false;
+  for (uint32_t i = 0; i < memoryProperties.memoryProperties.memoryHeapCount; ++i) {
+    if (!(memoryProperties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT))
+      continue;
+
+    auto heapHeadroom = memoryBudget.heapBudget[i] > memoryBudget.heapUsage[i]
+                            ? memoryBudget.heapBudget[i] - memoryBudget.heapUsage[i]
+                            : 0;
+    headroom = found ? std::min<uint64_t>(headroom, heapHeadroom) : heapHeadroom;
+    found = true;
+  }
 
-  _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(), _ImageResourcesToLoad.begin() + loadParameterCount);
+  return found;
 }
 
 void VulkanHook_t::_ReleaseResources() {
+  _RemoveReleasedImageResources(_ImageResourcesToRelease);
+
   if (_ImageResourcesToRelease.empty())
     return;
 
@@ -1351,12 +1601,12 @@ VKAPI_ATTR void VKAPI_CALL VulkanHook_t::_MyVkDestroyDevice(VkDevice device, con
 VulkanHook_t::VulkanHook_t()
     : _Hooked(false), _X11Hooked(false), _Window(nullptr), _SentOutOfDate(false),
       _HookState(OverlayHookState::Removing), _VulkanLoader(nullptr), _VulkanAllocationCallbacks(nullptr),
-      _VulkanInstance(VK_NULL_HANDLE), _VulkanPhysicalDevice(VK_NULL_HANDLE), _VulkanQueueFamily(uint32_t(-1)),
-      _VulkanImageCommandPool(VK_NULL_HANDLE), _VulkanImageCommandBuffer(VK_NULL_HANDLE),
+      _VulkanInstance(VK_NULL_HANDLE), _VulkanPhysicalDevice(VK_NULL_HANDLE), _VulkanMemoryBudgetSupported(false),
+      _VulkanQueueFamily(uint32_t(-1)), _VulkanImageCommandPool(VK_NULL_HANDLE), _VulkanImageCommandBuffer(VK_NULL_HANDLE),
       _VulkanImageFence(VK_NULL_HANDLE), _VulkanImageSampler(VK_NULL_HANDLE),
       _VulkanImageDescriptorSetLayout(VK_NULL_HANDLE), _VulkanRenderPass(VK_NULL_HANDLE),
-      _VulkanTargetFormat(VK_FORMAT_R8G8B8A8_UNORM), _VulkanDevice(VK_NULL_HANDLE), _VulkanQueue(VK_NULL_HANDLE),
-      _ImGuiFontAtlas(nullptr),
+      _DescriptorSetReservations(0), _VulkanTargetFormat(VK_FORMAT_R8G8B8A8_UNORM), _VulkanDevice(VK_NULL_HANDLE), _VulkanDeviceGeneration(0), _VulkanQueue(VK_NULL_HANDLE),
+      _StagingDevice(VK_NULL_HANDLE), _ImGuiFontAtlas(nullptr),
 
       _VkAcquireNextImageKHR(nullptr), _VkAcquireNextImage2KHR(nullptr), _VkQueuePresentKHR(nullptr),
       _VkCreateSwapchainKHR(nullptr), _VkDestroyDevice(nullptr),
@@ -1380,8 +1630,9 @@ VulkanHook_t::VulkanHook_t()
       _vkUpdateDescriptorSets(nullptr), _vkFreeDescriptorSets(nullptr), _vkGetBufferMemoryRequirements(nullptr),
       _vkGetImageMemoryRequirements(nullptr), _vkEnumeratePhysicalDevices(nullptr),
       _vkGetPhysicalDeviceSurfaceFormatsKHR(nullptr), _vkGetPhysicalDeviceProperties(nullptr),
-      _vkGetPhysicalDeviceQueueFamilyProperties(nullptr), _vkGetPhysicalDeviceMemoryProperties(nullptr),
-      _vkEnumerateDeviceExtensionProperties(nullptr) {}
+      _vkGetPhysicalDeviceFormatProperties(nullptr), _vkGetPhysicalDeviceQueueFamilyProperties(nullptr),
+      _vkGetPhysicalDeviceMemoryProperties(nullptr),
+      _vkEnumerateDeviceExtensionProperties(nullptr), _vkGetPhysicalDeviceMemoryProperties2KHR(nullptr) {}
 
 VulkanHook_t::~VulkanHook_t() {
   INGAMEOVERLAY_INFO("VulkanHook_t Hook removed");
@@ -1423,10 +1674,10 @@ void VulkanHook_t::LoadFunctions(std::function<void*(const char*)> vkLoader,
   _VkDestroyDevice = vkDestroyDevice;
 }
 
-std::weak_ptr<RendererTexture_t> VulkanHook_t::AllocImageResource() {
+RendererTextureHandle_t VulkanHook_t::AllocImageResource() {
   auto vulkanImageDescriptor = _GetFreeDescriptorSet();
   if (vulkanImageDescriptor.DescriptorPoolId == VulkanDescriptorSet_t::InvalidDescriptorPoolId)
-    return std::weak_ptr<RendererTexture_t>{};
+    return RendererTextureHandle_t{};
 
   auto ptr = std::shared_ptr<VulkanTexture_t>(new VulkanTexture_t, [this](VulkanTexture_t* handle) {
     if (handle != nullptr) {
@@ -1442,24 +1693,162 @@ std::weak_ptr<RendererTexture_t> VulkanHook_t::AllocImageResource() {
   ptr->ImGuiTextureId = (uint64_t)vulkanImageDescriptor.DescriptorSet;
   ptr->ImageDescriptorId = vulkanImageDescriptor;
 
-  _ImageResources.emplace(ptr);
-
-  return ptr;
+  return _ImageResources.Insert(std::move(ptr));
 }
 
-void VulkanHook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter) {
-  _ImageResourcesToLoad.emplace_back(loadParameter);
-}
+std::shared_ptr<RendererStagingBuffer_t> VulkanHook_t::_AllocStagingBuffer(uint32_t width, uint32_t height) {
+  // Copies must start on a texel block boundary, 16 fits every format.
+  const VkDeviceSize size = (VkDeviceSize(width) * height * 4 + 15) & ~VkDeviceSize(15);
+
+  {
+    std::lock_guard<std::mutex> lock(_StagingMutex);
+    if (_StagingDevice != VK_NULL_HANDLE && size != 0) {
+      std::shared_ptr<VulkanStagingPage_t> page;
+      for (auto& candidate : _StagingPages) {
+        if (candidate->Size - candidate->Used >= size) {
+          page = candidate;
+          break;
+        }
+      }
+
+      if (page == nullptr) {
+        page = _AllocStagingPage(std::max(size, StagingPageSize));
+        if (page == nullptr)
+          return nullptr;
+
+        _StagingPages.emplace_back(page);
+      }
 
-void VulkanHook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) {
-  auto ptr = resource.lock();
-  if (ptr) {
-    auto it = _ImageResources.find(ptr);
-    if (it != _ImageResources.end()) {
-      _ImageResources.erase(it);
-      _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t{std::move(ptr), _CurrentFrame});
+      auto buffer = std::shared_ptr<VulkanStagingBuffer_t>(new VulkanStagingBuffer_t, [this, page](VulkanStagingBuffer_t* handle) {
+        _ReleaseStagingBuffer(*page, *handle);
+        delete handle;
+      });
+      buffer->DeviceGeneration = _VulkanDeviceGeneration;
+      buffer->Buffer = page->Buffer;
+      buffer->Offset = page->Used;
+      buffer->Page = page.get();
+      buffer->Data = page->Data + page->Used;
+      buffer->Pitch = width * 4;
+      buffer->RendererMemory = true;
+
+      page->Used += size;
+      ++page->Allocations;
+      ++page->Writers;
+      return buffer;
     }
   }
+
+  // No device to map memory from yet, the pixels will go through the upload buffer.
+  return RendererHookInternal_t::_AllocStagingBuffer(width, height);
+}
+
+std::shared_ptr<VulkanHook_t::VulkanStagingPage_t> VulkanHook_t::_AllocStagingPage(VkDeviceSize size) {
+  auto page = std::make_shared<VulkanStagingPage_t>();
+  page->Size = size;
+
+  VkBufferCreateInfo buffer_info{};
+  buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_info.size = size;
+  buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+  if (_vkCreateBuffer(_StagingDevice, &buffer_info, _VulkanAllocationCallbacks, &page->Buffer) != VK_SUCCESS)
+    return nullptr;
+
+  VkMemoryRequirements req;
+  _vkGetBufferMemoryRequirements(_StagingDevice, page->Buffer, &req);
+
+  VkMemoryAllocateInfo alloc{};
+  alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  alloc.allocationSize = req.size;
+  alloc.memoryTypeIndex = _GetVulkanMemoryType(
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, req.memoryTypeBits);
+
+  // Stays mapped until the page is destroyed, the memory is coherent so the writes need no flush.
+  if (alloc.memoryTypeIndex == 0xFFFFFFFF ||
+      _vkAllocateMemory(_StagingDevice, &alloc, _VulkanAllocationCallbacks, &page->Memory) != VK_SUCCESS ||
+      _vkBindBufferMemory(_StagingDevice, page->Buffer, page->Memory, 0) != VK_SUCCESS ||
+      _vkMapMemory(_StagingDevice, page->Memory, 0, VK_WHOLE_SIZE, 0, (void**)&page->Data) != VK_SUCCESS) {
+    _DestroyStagingPage(_StagingDevice, *page);
+    return nullptr;
+  }
+
+  return page;
+}
+
+void VulkanHook_t::_DestroyStagingPage(VkDevice device, VulkanStagingPage_t& page) {
+  // Freeing the memory unmaps it.
+  if (page.Memory != VK_NULL_HANDLE)
+    _vkFreeMemory(device, page.Memory, _VulkanAllocationCallbacks);
+
+  if (page.Buffer != VK_NULL_HANDLE)
+    _vkDestroyBuffer(device, page.Buffer, _VulkanAllocationCallbacks);
+
+  page.Buffer = VK_NULL_HANDLE;
+  page.Memory = VK_NULL_HANDLE;
+  page.Data = nullptr;
+}
+
+void VulkanHook_t::_EndStagingWrite(RendererStagingBuffer_t& buffer) {
+  if (!buffer.RendererMemory)
+    return;
+
+  auto& stagingBuffer = static_cast<VulkanStagingBuffer_t&>(buffer);
+  std::lock_guard<std::mutex> lock(_StagingMutex);
+  _EndStagingPageWrite(*stagingBuffer.Page, stagingBuffer);
+}
+
+void VulkanHook_t::_EndStagingPageWrite(VulkanStagingPage_t& page, VulkanStagingBuffer_t& buffer) {
+  if (!buffer.Writing)
+    return;
+
+  buffer.Writing = false;
+  if (--page.Writers == 0)
+    _StagingWritesEnded.notify_all();
+}
+
+void VulkanHook_t::_ReleaseStagingBuffer(VulkanStagingPage_t& page, VulkanStagingBuffer_t& buffer) {
+  std::lock_guard<std::mutex> lock(_StagingMutex);
+  // Released without EndWrite, by a new BeginWrite or the resource going away.
+  _EndStagingPageWrite(page, buffer);
+
+  // Already destroyed with its device, or about to be.
+  if (--page.Allocations != 0 || page.Buffer == VK_NULL_HANDLE || _StagingDevice == VK_NULL_HANDLE)
+    return;
+
+  page.Used = 0;
+
+  // Keeps a single empty page for the next writes, a burst of tiles doesn't hold its memory forever.
+  auto emptyPages = std::count_if(_StagingPages.begin(), _StagingPages.end(), [](std::shared_ptr<VulkanStagingPage_t> const& p) {
+    return p->Allocations == 0;
+  });
+  if (emptyPages <= 1)
+    return;
+
+  _DestroyStagingPage(_StagingDevice, page);
+  _StagingPages.erase(std::find_if(_StagingPages.begin(), _StagingPages.end(), [&page](std::shared_ptr<VulkanStagingPage_t> const& p) {
+    return p.get() == &page;
+  }));
+}
+
+void VulkanHook_t::_DestroyStagingPages() {
+  std::unique_lock<std::mutex> lock(_StagingMutex);
+  // No new range is handed out from now on.
+  auto device = _StagingDevice;
+  _StagingDevice = VK_NULL_HANDLE;
+
+  // The application may still be writing into a page, it is unmapped only once every EndWrite is done.
+  _StagingWritesEnded.wait(lock, [this]() {
+    return std::all_of(_StagingPages.begin(), _StagingPages.end(), [](std::shared_ptr<VulkanStagingPage_t> const& page) {
+      return page->Writers == 0;
+    });
+  });
+
+  // The ranges still handed out keep their page object, their uploads are dropped since the generation changes.
+  for (auto& page : _StagingPages)
+    _DestroyStagingPage(device, *page);
+
+  _StagingPages.clear();
+  ++_VulkanDeviceGeneration;
 }
 
 } // namespace InGameOverlay
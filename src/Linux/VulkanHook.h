@@ -25,6 +25,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include <condition_variable>
+
 namespace InGameOverlay {
 
 class VulkanHook_t :
@@ -33,6 +35,8 @@ class VulkanHook_t :
 {
 public:
     constexpr static uint32_t MaxDescriptorCountPerPool = 1024;
+    // BeginWrite suballocates from pages of this size, a bigger image gets its own page.
+    constexpr static VkDeviceSize StagingPageSize = 16 * 1024 * 1024;
 
     struct VulkanDescriptorSet_t
     {
@@ -57,6 +61,31 @@ private:
         VkFence Fence = VK_NULL_HANDLE;
     };
 
+    // Persistently mapped upload memory, BeginWrite hands out ranges of it instead of allocating device memory each time.
+    struct VulkanStagingPage_t
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VkDeviceMemory Memory = VK_NULL_HANDLE;
+        uint8_t* Data = nullptr;
+        VkDeviceSize Size = 0;
+        VkDeviceSize Used = 0;
+        // Ranges not released yet, the page is filled again from its start once it drops to 0.
+        uint32_t Allocations = 0;
+        // Ranges between BeginWrite and EndWrite, the page stays mapped until it drops to 0.
+        uint32_t Writers = 0;
+    };
+
+    // Range of a staging page handed out by BeginWrite, the texture is copied straight from it.
+    struct VulkanStagingBuffer_t : RendererStagingBuffer_t
+    {
+        uint32_t DeviceGeneration = 0;
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VkDeviceSize Offset = 0;
+        // Kept alive by the buffer deleter.
+        VulkanStagingPage_t* Page = nullptr;
+        bool Writing = true;
+    };
+
     struct VulkanDescriptorPool_t
     {
         VkDescriptorPool DescriptorPool;
@@ -74,6 +103,7 @@ private:
     VkAllocationCallbacks* _VulkanAllocationCallbacks;
     VkInstance _VulkanInstance;
     VkPhysicalDevice _VulkanPhysicalDevice;
+    bool _VulkanMemoryBudgetSupported;
     std::vector<VkQueueFamilyProperties> _VulkanQueueFamilies;
     uint32_t _VulkanQueueFamily;
     VkCommandPool _VulkanImageCommandPool;
@@ -84,13 +114,24 @@ private:
     std::vector<VulkanFrame_t> _OverlayFrames;
     VkRenderPass _VulkanRenderPass;
     std::vector<VulkanDescriptorPool_t> _DescriptorsPools;
+    // Allocated ahead for the resources created by CreateResources.
+    std::vector<VulkanDescriptorSet_t> _ReservedDescriptorSets;
+    // Announced by CreateResources from any thread, allocated by the next AllocImageResource.
+    std::atomic<uint32_t> _DescriptorSetReservations;
     VkFormat _VulkanTargetFormat;
 
     VkDevice _VulkanDevice;
+    // Bumped when the device resources are freed, a handle value can be reused by the next device.
+    uint32_t _VulkanDeviceGeneration;
     VkQueue _VulkanQueue;
 
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
+    // BeginWrite is called from any thread, the staging pages and their device are only used under this lock.
+    std::mutex _StagingMutex;
+    VkDevice _StagingDevice;
+    std::vector<std::shared_ptr<VulkanStagingPage_t>> _StagingPages;
+    // Signaled when a page has no writer left.
+    std::condition_variable _StagingWritesEnded;
+
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
 
@@ -99,6 +140,7 @@ private:
 
     bool _AllocDescriptorPool();
     VulkanDescriptorSet_t _GetFreeDescriptorSetFromPool(uint32_t poolIndex);
+    void _ReserveDescriptorSets(uint32_t count);
     VulkanDescriptorSet_t _GetFreeDescriptorSet();
     void _ReleaseDescriptor(VulkanDescriptorSet_t descriptorSet);
     void _DestroyDescriptorPools();
@@ -110,6 +152,18 @@ private:
 
     void _PrepareForOverlay(VkQueue queue, const VkPresentInfoKHR* pPresentInfo);
     void _LoadResources();
+    virtual bool _GetTextureMemoryHeadroom(uint64_t& headroom);
+    virtual bool _GetDescriptorUsage(uint32_t& used, uint32_t& capacity);
+    virtual bool _SupportsResourceFormat(RendererResourceFormat_t format);
+    virtual bool _SupportsResourceMipLevels();
+    virtual std::shared_ptr<RendererStagingBuffer_t> _AllocStagingBuffer(uint32_t width, uint32_t height);
+    virtual void _EndStagingWrite(RendererStagingBuffer_t& buffer);
+    virtual void _ReserveImageResources(uint32_t count);
+    std::shared_ptr<VulkanStagingPage_t> _AllocStagingPage(VkDeviceSize size);
+    void _DestroyStagingPage(VkDevice device, VulkanStagingPage_t& page);
+    void _EndStagingPageWrite(VulkanStagingPage_t& page, VulkanStagingBuffer_t& buffer);
+    void _ReleaseStagingBuffer(VulkanStagingPage_t& page, VulkanStagingBuffer_t& buffer);
+    void _DestroyStagingPages();
     void _ReleaseResources();
     void _HandleScreenshot(VulkanFrame_t& frame);
 
@@ -216,9 +270,11 @@ private:
     decltype(::vkEnumeratePhysicalDevices)               *_vkEnumeratePhysicalDevices;
     decltype(::vkGetPhysicalDeviceSurfaceFormatsKHR)     *_vkGetPhysicalDeviceSurfaceFormatsKHR;
     decltype(::vkGetPhysicalDeviceProperties)            *_vkGetPhysicalDeviceProperties;
+    decltype(::vkGetPhysicalDeviceFormatProperties)      *_vkGetPhysicalDeviceFormatProperties;
     decltype(::vkGetPhysicalDeviceQueueFamilyProperties) *_vkGetPhysicalDeviceQueueFamilyProperties;
     decltype(::vkGetPhysicalDeviceMemoryProperties)      *_vkGetPhysicalDeviceMemoryProperties;
     decltype(::vkEnumerateDeviceExtensionProperties)     *_vkEnumerateDeviceExtensionProperties;
+    decltype(::vkGetPhysicalDeviceMemoryProperties2KHR)  *_vkGetPhysicalDeviceMemoryProperties2KHR;
 
 public:
     std::string LibraryName;
@@ -228,6 +284,9 @@ public:
     virtual bool StartHook(std::function<void()> keyCombinationCallback, ToggleKey toggleKeys[], int toggleKeysCount, /*ImFontAtlas* */ void* imguiFontAtlas = nullptr);
     virtual void HideAppInputs(bool hide);
     virtual void HideOverlayInputs(bool hide);
+    virtual bool SetDedicatedInputThread(bool enabled);
+    virtual bool SetCoalesceScrollEvents(bool coalesce);
+    virtual uint64_t GetCoalescedInputEventCount();
     virtual bool IsStarted();
     static VulkanHook_t* Inst();
     virtual const char* GetLibraryName() const;
@@ -240,9 +299,7 @@ public:
         decltype(::vkCreateSwapchainKHR)* vkCreateSwapchainKHR,
         decltype(::vkDestroyDevice)* vkDestroyDevice);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
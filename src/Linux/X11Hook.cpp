@@ -19,12 +19,20 @@
 
 #include "X11Hook.h"
 
+#include <X11/extensions/XInput2.h>
+#include <X11/Xlib-xcb.h>
+#include <xcb/xinput.h>
+
 #undef Status
 
 #include <imgui.h>
 #include <backends/imgui_impl_x11.h>
 #include <System/Library.h>
 
+#include <cstdlib>
+
+#include <poll.h>
+
 extern int ImGui_ImplX11_EventHandler(XEvent& event, XEvent* nextEvent);
 
 namespace InGameOverlay {
@@ -33,57 +41,113 @@ static constexpr const char X11_DLL_NAME[] = "libX11.so";
 
 X11Hook_t* X11Hook_t::_inst = nullptr;
 
-static std::shared_ptr<Display> GetX11Display()
+static std::shared_ptr<xcb_connection_t> GetXcbConnection(xcb_window_t& rootWindow)
 {
-    auto displayHandle = XOpenDisplay(nullptr);
-    if (displayHandle == nullptr)
-        return std::shared_ptr<Display>(nullptr);
+    int screenNumber = 0;
+    auto connectionHandle = xcb_connect(nullptr, &screenNumber);
+    if (xcb_connection_has_error(connectionHandle))
+    {
+        xcb_disconnect(connectionHandle);
+        return std::shared_ptr<xcb_connection_t>(nullptr);
+    }
 
-    return std::shared_ptr<Display>(displayHandle, [](Display* handle)
+    rootWindow = XCB_WINDOW_NONE;
+    for (auto it = xcb_setup_roots_iterator(xcb_get_setup(connectionHandle)); it.rem; --screenNumber, xcb_screen_next(&it))
+    {
+        if (screenNumber == 0)
+        {
+            rootWindow = it.data->root;
+            break;
+        }
+    }
+
+    return std::shared_ptr<xcb_connection_t>(connectionHandle, [](xcb_connection_t* handle)
     {
         if (handle != nullptr)
-            XCloseDisplay(handle);
+            xcb_disconnect(handle);
     });
 }
 
-typedef int (*EnumX11WindowsCallback_t)(Display* display, Window window, void* userParameter);
+static xcb_atom_t GetXcbAtomReply(xcb_connection_t* connection, xcb_intern_atom_cookie_t cookie)
+{
+    xcb_atom_t atom = XCB_ATOM_NONE;
+    auto reply = xcb_intern_atom_reply(connection, cookie, nullptr);
+    if (reply != nullptr)
+    {
+        atom = reply->atom;
+        free(reply);
+    }
+
+    return atom;
+}
 
-static void RunEnumX11Windows(Display* display, Window rootWindow, EnumX11WindowsCallback_t callback, void* userParameter)
+static bool XcbWindowHasPid(xcb_connection_t* connection, xcb_get_property_cookie_t cookie, int32_t processId)
 {
-    Window parentWindow;
-    Window* childrenWindows;
-    Window* child;
-    unsigned int childCount;
+    auto reply = xcb_get_property_reply(connection, cookie, nullptr);
+    if (reply == nullptr)
+        return false;
 
-    if (XQueryTree(display, rootWindow, &rootWindow, &parentWindow, &childrenWindows, &childCount) && childCount)
+    int32_t windowProcessId = 0;
+    bool found = false;
+    if (xcb_get_property_value_length(reply) > 0)
     {
-        for (unsigned int i = 0; i < childCount; ++i)
+        auto value = xcb_get_property_value(reply);
+        switch (reply->format)
         {
-            if (!callback(display, childrenWindows[i], userParameter))
-                return;
-
-            RunEnumX11Windows(display, childrenWindows[i], callback, userParameter);
+            case 32: windowProcessId = *(int32_t*)value; found = true; break;
+            case 16: windowProcessId = *(int16_t*)value; found = true; break;
+            case 8 : windowProcessId = *(uint8_t*)value; found = true; break;
         }
     }
+    free(reply);
+
+    return found && windowProcessId == processId;
 }
 
-static void EnumX11Windows(EnumX11WindowsCallback_t callback, void* userParameter, Display* display = nullptr)
+// Sends every _NET_WM_PID request before reading the first reply, so the whole list costs a single round-trip.
+static void FilterXcbWindowsByPid(xcb_connection_t* connection, std::vector<xcb_window_t> const& windows, xcb_atom_t pidAtom, int32_t processId, std::vector<Window>& result)
 {
-    std::shared_ptr<Display> localDisplay;
-    if (display == nullptr)
+    std::vector<xcb_get_property_cookie_t> cookies;
+    cookies.reserve(windows.size());
+    for (auto window : windows)
+        cookies.emplace_back(xcb_get_property(connection, 0, window, pidAtom, XCB_GET_PROPERTY_TYPE_ANY, 0, 1));
+
+    for (size_t i = 0; i < windows.size(); ++i)
     {
-        localDisplay = GetX11Display();
-        display = localDisplay.get();
+        if (XcbWindowHasPid(connection, cookies[i], processId))
+            result.emplace_back((Window)windows[i]);
     }
+}
 
-    if (display == nullptr)
-        return;
+// Walks the window tree one depth level at a time, each level costs one round-trip instead of one per window.
+static void FindXcbWindowsInTree(xcb_connection_t* connection, xcb_window_t rootWindow, xcb_atom_t pidAtom, int32_t processId, std::vector<Window>& result)
+{
+    std::vector<xcb_window_t> windows{ rootWindow };
+    std::vector<xcb_window_t> children;
+    std::vector<xcb_query_tree_cookie_t> treeCookies;
 
-    Window rootWindow = DefaultRootWindow(display);
-    if (rootWindow == None || !callback(display, rootWindow, userParameter))
-        return;
+    while (!windows.empty())
+    {
+        treeCookies.clear();
+        for (auto window : windows)
+            treeCookies.emplace_back(xcb_query_tree(connection, window));
+
+        FilterXcbWindowsByPid(connection, windows, pidAtom, processId, result);
+
+        children.clear();
+        for (auto cookie : treeCookies)
+        {
+            auto reply = xcb_query_tree_reply(connection, cookie, nullptr);
+            if (reply == nullptr)
+                continue;
+
+            auto childrenWindows = xcb_query_tree_children(reply);
+            children.insert(children.end(), childrenWindows, childrenWindows + xcb_query_tree_children_length(reply));
+            free(reply);
+        }
 
-    RunEnumX11Windows(display, rootWindow, callback, userParameter);
+        std::swap(windows, children);
+    }
 }
 
 static uint32_t ToggleKeyToNativeKey(InGameOverlay::ToggleKey k)
@@ -206,11 +270,26 @@ bool X11Hook_t::StartHook(std::function<void()>& keyCombinationCallback, ToggleK
 void X11Hook_t::HideAppInputs(bool hide)
 {
     _ApplicationInputsHidden = hide;
+    _UpdateInputPath();
 }
 
 void X11Hook_t::HideOverlayInputs(bool hide)
 {
     _OverlayInputsHidden = hide;
+    _UpdateInputPath();
+}
+
+void X11Hook_t::SetCoalesceScrollEvents(bool coalesce)
+{
+    _CoalesceScrollEvents = coalesce;
+}
+
+bool X11Hook_t::SetDedicatedInputThread(bool enabled)
+{
+    // Only recorded here, PrepareForOverlay restarts the thread in the right mode on the render thread.
+    _InputThreadWanted = enabled;
+
+    return !enabled || !_InputThreadUnavailable;
 }
 
 void X11Hook_t::ResetRenderState(OverlayHookState state)
@@ -220,6 +299,10 @@ void X11Hook_t::ResetRenderState(OverlayHookState state)
 
     _Display = nullptr;
     _GameWnd = 0;
+    _PendingWheelX = 0.0f;
+    _PendingWheelY = 0.0f;
+
+    _StopInputThread();
 
     HideAppInputs(false);
     HideOverlayInputs(true);
@@ -267,6 +350,17 @@ bool X11Hook_t::PrepareForOverlay(Window wnd)
         _Initialized = true;
     }
 
+    if (_InputThread.joinable() && _InputThreadFeedsOverlay != _InputThreadWanted)
+        _StopInputThread();
+
+    if (!_InputThread.joinable() && !_InputThreadUnavailable)
+        _StartInputThread(wnd);
+
+    _CheckInputThreadStarted();
+
+    if (_InputThreadRunning)
+        _ProcessInputThreadEvents();
+
     if (!_OverlayInputsHidden)
     {
         ImGui_ImplX11_NewFrame();
@@ -275,49 +369,431 @@ bool X11Hook_t::PrepareForOverlay(Window wnd)
     return true;
 }
 
-std::vector<Window> X11Hook_t::FindApplicationX11Window(int32_t processId)
+void X11Hook_t::_StartInputThread(Window wnd)
+{
+    std::promise<bool> selected;
+    _InputThreadSelected = selected.get_future();
+
+    _KeyCombinationPending = false;
+    _InputThreadFeedsOverlay = _InputThreadWanted;
+    _InputThreadStopping = false;
+    _InputThread = std::thread(&X11Hook_t::_InputThreadProc, this, wnd, _InputThreadFeedsOverlay, std::move(selected));
+}
+
+void X11Hook_t::_CheckInputThreadStarted()
+{
+    if (!_InputThreadSelected.valid() || _InputThreadSelected.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    // The fast path is only taken once the thread watches the key combination, the application events would hide it otherwise.
+    if (_InputThreadSelected.get())
+    {
+        _InputThreadRunning = true;
+        _UpdateInputPath();
+    }
+    else
+    {
+        _InputThread.join();
+        _InputThreadUnavailable = true;
+    }
+}
+
+void X11Hook_t::_StopInputThread()
+{
+    _InputThreadRunning = false;
+    // Go back to the full events filtering before the toggle keys stop being watched.
+    _UpdateInputPath();
+
+    _InputThreadStopping = true;
+    if (_InputThread.joinable())
+        _InputThread.join();
+
+    _InputThreadSelected = std::future<bool>();
+
+    X11HookEvent_t inputEvent;
+    while (_InputEvents.dequeue(inputEvent));
+
+    _KeyCombinationPending = false;
+}
+
+void X11Hook_t::_UpdateInputPath()
+{
+    // The application events only need to be looked at when they are hidden or when ImGui reads its inputs from them.
+    _FastInputPath = _InputThreadRunning && !_ApplicationInputsHidden && (_OverlayInputsHidden || _InputThreadFeedsOverlay);
+}
+
+bool X11Hook_t::_ConsumeKeyCombination(Display* d)
+{
+    // Plain load first, the exchange is only paid when the combination has been pressed.
+    if (!_KeyCombinationPending.load(std::memory_order_relaxed) || !_KeyCombinationPending.exchange(false))
+        return false;
+
+    _KeyCombinationCallback();
+
+    if (_ApplicationInputsHidden)
+    {
+        // Save the last known cursor pos when opening the overlay
+        // so we can spoof the XQueryPointer return value.
+        _XQueryPointer(d, _GameWnd, &_SavedRoot, &_SavedChild, &_SavedCursorRX, &_SavedCursorRY, &_SavedCursorX, &_SavedCursorY, &_SavedMask);
+    }
+
+    return true;
+}
+
+static void XIDeviceEventToXEvent(XIDeviceEvent const& deviceEvent, XEvent& event)
+{
+    // Rebuild the core event the ImGui X11 backend knows how to handle.
+    // Key, button and motion events share the same layout up to the state field.
+    event.xkey.serial = deviceEvent.serial;
+    event.xkey.send_event = deviceEvent.send_event;
+    event.xkey.display = deviceEvent.display;
+    event.xkey.window = deviceEvent.event;
+    event.xkey.root = deviceEvent.root;
+    event.xkey.subwindow = deviceEvent.child;
+    event.xkey.time = deviceEvent.time;
+    event.xkey.x = (int)deviceEvent.event_x;
+    event.xkey.y = (int)deviceEvent.event_y;
+    event.xkey.x_root = (int)deviceEvent.root_x;
+    event.xkey.y_root = (int)deviceEvent.root_y;
+    event.xkey.state = deviceEvent.mods.effective;
+    event.xkey.same_screen = True;
+
+    switch (deviceEvent.evtype)
+    {
+        case XI_KeyPress     : event.type = KeyPress     ; event.xkey.keycode = deviceEvent.detail   ; break;
+        case XI_KeyRelease   : event.type = KeyRelease   ; event.xkey.keycode = deviceEvent.detail   ; break;
+        case XI_ButtonPress  : event.type = ButtonPress  ; event.xbutton.button = deviceEvent.detail ; break;
+        case XI_ButtonRelease: event.type = ButtonRelease; event.xbutton.button = deviceEvent.detail ; break;
+        case XI_Motion       : event.type = MotionNotify ; event.xmotion.is_hint = NotifyNormal      ; break;
+    }
+}
+
+// The input thread requests go through XCB checked requests, their errors come back here instead of reaching the process wide Xlib error handler.
+// Only one client can select the button presses on a window, the server answers BadAccess if the game already does.
+static bool SelectInputThreadEvents(xcb_connection_t* connection, xcb_window_t window, uint32_t eventMask)
 {
     struct
     {
-        int32_t pid;
-        std::vector<Window> windows;
-        Atom pidAtom;
-    } windowParams{
-        processId,
-        {},
-        None
-    };
+        xcb_input_event_mask_t Header;
+        uint32_t Mask;
+    } mask;
+
+    mask.Header.deviceid = XCB_INPUT_DEVICE_ALL_MASTER;
+    mask.Header.mask_len = 1;
+    mask.Mask = eventMask;
+
+    auto error = xcb_request_check(connection, xcb_input_xi_select_events_checked(connection, window, 1, &mask.Header));
+    if (error == nullptr)
+        return true;
+
+    free(error);
+    return false;
+}
+
+static bool IsWindowFocused(xcb_connection_t* connection, xcb_window_t window)
+{
+    auto focusReply = xcb_get_input_focus_reply(connection, xcb_get_input_focus(connection), nullptr);
+    if (focusReply == nullptr)
+        return false;
+
+    xcb_window_t focusWindow = focusReply->focus;
+    free(focusReply);
+
+    // The focus can be on one of the game window children.
+    while (focusWindow != XCB_WINDOW_NONE && focusWindow != XCB_INPUT_FOCUS_POINTER_ROOT)
+    {
+        if (focusWindow == window)
+            return true;
+
+        // The focused window may be destroyed meanwhile, the error is returned with the missing reply.
+        xcb_generic_error_t* error = nullptr;
+        auto treeReply = xcb_query_tree_reply(connection, xcb_query_tree(connection, focusWindow), &error);
+        if (treeReply == nullptr)
+        {
+            free(error);
+            break;
+        }
+
+        const bool reachedRoot = treeReply->parent == treeReply->root;
+        focusWindow = treeReply->parent;
+        free(treeReply);
+
+        if (reachedRoot)
+            break;
+    }
+
+    return false;
+}
+
+void X11Hook_t::_InputThreadProc(Window wnd, bool readDeviceEvents, std::promise<bool> selected)
+{
+    // The failures are only reported through selected, the render thread owns the input path flags.
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        INGAMEOVERLAY_WARN("Failed to start the X11 input thread: Cannot open display.");
+        selected.set_value(false);
+        return;
+    }
+
+    // XIQueryVersion also registers XInput2 on the display, XGetEventData needs it.
+    int xiOpcode, xiEvent, xiError;
+    int xiMajor = 2, xiMinor = 0;
+    if (!XQueryExtension(display, "XInputExtension", &xiOpcode, &xiEvent, &xiError) || XIQueryVersion(display, &xiMajor, &xiMinor) != Success)
+    {
+        INGAMEOVERLAY_WARN("Failed to start the X11 input thread: XInput2 is not available.");
+        XCloseDisplay(display);
+        selected.set_value(false);
+        return;
+    }
+
+    auto connection = XGetXCBConnection(display);
+
+    uint32_t windowMask = 0;
+    if (readDeviceEvents)
+    {
+        windowMask |= XCB_INPUT_XI_EVENT_MASK_KEY_PRESS | XCB_INPUT_XI_EVENT_MASK_KEY_RELEASE;
+        windowMask |= XCB_INPUT_XI_EVENT_MASK_BUTTON_PRESS | XCB_INPUT_XI_EVENT_MASK_BUTTON_RELEASE;
+        windowMask |= XCB_INPUT_XI_EVENT_MASK_MOTION;
+    }
+    // Raw key events are global, the focus tells if the key combination was meant for the game.
+    windowMask |= XCB_INPUT_XI_EVENT_MASK_FOCUS_IN | XCB_INPUT_XI_EVENT_MASK_FOCUS_OUT;
 
-    EnumX11Windows([](Display* display, Window window, void* userParameter) -> int
+    if (!SelectInputThreadEvents(connection, (xcb_window_t)wnd, windowMask))
     {
-        auto params = reinterpret_cast<decltype(windowParams)*>(userParameter);
-        if (params->pidAtom == None)
-            params->pidAtom = XInternAtom(display, "_NET_WM_PID", True);
+        INGAMEOVERLAY_WARN("Failed to start the X11 input thread: The window events are already selected by another client.");
+        XCloseDisplay(display);
+        selected.set_value(false);
+        return;
+    }
+
+    // Raw events can only be selected on the root window, they report the keyboard even when the game window has no focus.
+    if (!SelectInputThreadEvents(connection, (xcb_window_t)DefaultRootWindow(display), XCB_INPUT_XI_EVENT_MASK_RAW_KEY_PRESS | XCB_INPUT_XI_EVENT_MASK_RAW_KEY_RELEASE))
+    {
+        INGAMEOVERLAY_WARN("Failed to start the X11 input thread: Cannot select the raw key events.");
+        XCloseDisplay(display);
+        selected.set_value(false);
+        return;
+    }
+
+    std::vector<int> keyCombinationCodes;
+    for (auto const& key : _NativeKeyCombination)
+        keyCombinationCodes.emplace_back(XKeysymToKeycode(display, key));
+
+    // Keyboard state tracked from the raw key events, same layout as XQueryKeymap.
+    uint8_t keyStates[32] = {};
+    bool keyCombinationPushed = false;
+    bool windowFocused = IsWindowFocused(connection, (xcb_window_t)wnd);
+
+    XFlush(display);
+
+    selected.set_value(true);
+
+    pollfd pollDescriptor{ ConnectionNumber(display), POLLIN, 0 };
+    XEvent event;
+
+    while (!_InputThreadStopping)
+    {
+        if (XPending(display) == 0)
+        {
+            // Wake up regularly to check if we've been asked to stop.
+            poll(&pollDescriptor, 1, 100);
+            continue;
+        }
 
-        if (params->pidAtom == None)
-            return 0;
+        XNextEvent(display, &event);
 
-        XTextProperty data;
-        int status = XGetTextProperty(display, window, &data, params->pidAtom);
-        if (!status || data.nitems <= 0)
-            return 1;
+        XGenericEventCookie* cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != xiOpcode || !XGetEventData(display, cookie))
+            continue;
 
-        int32_t processId = 0;
-        switch (data.format)
+        switch (cookie->evtype)
         {
-            case 32: processId = *(int32_t*)data.value; break;
-            case 16: processId = *(int16_t*)data.value; break;
-            case 8 : processId = data.value[0]; break;
-            default: return 1;
+            case XI_RawKeyPress: case XI_RawKeyRelease:
+            {
+                auto rawEvent = reinterpret_cast<XIRawEvent*>(cookie->data);
+                if (rawEvent->detail < 0 || rawEvent->detail >= 256)
+                    break;
+
+                const uint8_t bit = 1 << (rawEvent->detail % 8);
+                if (cookie->evtype == XI_RawKeyPress)
+                    keyStates[rawEvent->detail / 8] |= bit;
+                else
+                    keyStates[rawEvent->detail / 8] &= ~bit;
+
+                int keyCount = 0;
+                for (auto keyCode : keyCombinationCodes)
+                {
+                    if (keyStates[keyCode / 8] & (1 << (keyCode % 8)))
+                        ++keyCount;
+                }
+
+                if (windowFocused && keyCount == keyCombinationCodes.size())
+                {// All shortcut keys are pressed
+                    if (!keyCombinationPushed)
+                        _KeyCombinationPending = true;
+
+                    keyCombinationPushed = true;
+                }
+                else
+                {
+                    keyCombinationPushed = false;
+                }
+            }
+            break;
+
+            case XI_KeyPress: case XI_KeyRelease:
+            case XI_ButtonPress: case XI_ButtonRelease:
+            case XI_Motion:
+            {
+                XEvent coreEvent{};
+                XIDeviceEventToXEvent(*reinterpret_cast<XIDeviceEvent*>(cookie->data), coreEvent);
+                _InputEvents.enqueue(X11HookEvent_t(coreEvent));
+            }
+            break;
+
+            case XI_FocusIn: case XI_FocusOut:
+            {
+                auto focusEvent = reinterpret_cast<XIFocusInEvent*>(cookie->data);
+                // Focus moving to a child window doesn't take it away from the game.
+                if (focusEvent->detail != NotifyInferior)
+                    windowFocused = cookie->evtype == XI_FocusIn;
+
+                XEvent coreEvent{};
+                coreEvent.type = cookie->evtype == XI_FocusIn ? FocusIn : FocusOut;
+                coreEvent.xfocus.window = focusEvent->event;
+                coreEvent.xfocus.mode = focusEvent->mode;
+                coreEvent.xfocus.detail = focusEvent->detail;
+                _InputEvents.enqueue(X11HookEvent_t(coreEvent));
+            }
+            break;
         }
 
-        if (processId == params->pid)
-            params->windows.emplace_back(window);
+        XFreeEventData(display, cookie);
+    }
+
+    XCloseDisplay(display);
+}
+
+void X11Hook_t::_ProcessInputThreadEvents()
+{
+    X11HookEvent_t inputEvent;
+    size_t eventCount = _InputEvents.queue_size();
+    while (eventCount-- && _InputEvents.dequeue(inputEvent))
+    {
+        auto& event = inputEvent.Event;
+        const bool isFocusEvent = event.type == FocusIn || event.type == FocusOut;
+
+        if (isFocusEvent)
+            ImGui::GetIO().SetAppAcceptingEvents(event.type == FocusIn);
+
+        if (_OverlayInputsHidden && !isFocusEvent)
+            continue;
+
+        // The input thread connection keyboard mapping is the same, but ImGui must only talk to the game connection.
+        event.xany.display = _Display;
+        ImGui_ImplX11_EventHandler(event, nullptr);
+    }
+}
+
+void X11Hook_t::_PollApplicationWindowsEvents()
+{
+    xcb_generic_event_t* event;
+    while ((event = xcb_poll_for_event(_XcbConnection.get())) != nullptr)
+    {
+        switch (event->response_type & ~0x80)
+        {
+            case XCB_DESTROY_NOTIFY:
+            {
+                auto window = (Window)reinterpret_cast<xcb_destroy_notify_event_t*>(event)->window;
+                if (std::find(_ApplicationWindows.begin(), _ApplicationWindows.end(), window) != _ApplicationWindows.end())
+                    _ApplicationWindows.clear();
+            }
+            break;
 
-        return 1;
-    }, &windowParams);
+            // A window created or mapped later, like the game window replacing a launcher, must be searched again.
+            case XCB_CREATE_NOTIFY:
+            case XCB_MAP_NOTIFY:
+                _ApplicationWindows.clear();
+                break;
 
-    return windowParams.windows;
+            case XCB_PROPERTY_NOTIFY:
+                if (reinterpret_cast<xcb_property_notify_event_t*>(event)->atom == _XcbClientListAtom)
+                    _ApplicationWindows.clear();
+                break;
+        }
+        free(event);
+    }
+}
+
+std::vector<Window> X11Hook_t::FindApplicationX11Window(int32_t processId)
+{
+    if (_XcbConnection == nullptr)
+    {
+        _XcbConnection = GetXcbConnection(_XcbRootWindow);
+        if (_XcbConnection == nullptr)
+            return {};
+
+        // Watch the root window children and the window manager list, so new windows invalidate the result.
+        if (_XcbRootWindow != XCB_WINDOW_NONE)
+        {
+            const uint32_t rootEventMask = XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY | XCB_EVENT_MASK_PROPERTY_CHANGE;
+            xcb_change_window_attributes(_XcbConnection.get(), _XcbRootWindow, XCB_CW_EVENT_MASK, &rootEventMask);
+        }
+    }
+
+    auto connection = _XcbConnection.get();
+
+    // The result stays valid until one of the windows is destroyed.
+    _PollApplicationWindowsEvents();
+    if (!_ApplicationWindows.empty() && _ApplicationWindowsProcessId == processId)
+        return _ApplicationWindows;
+
+    _ApplicationWindows.clear();
+    _ApplicationWindowsProcessId = processId;
+
+    if (_XcbRootWindow == XCB_WINDOW_NONE)
+        return {};
+
+    static constexpr const char pidAtomName[] = "_NET_WM_PID";
+    static constexpr const char clientListAtomName[] = "_NET_CLIENT_LIST";
+
+    auto pidAtomCookie = xcb_intern_atom(connection, 1, sizeof(pidAtomName) - 1, pidAtomName);
+    auto clientListAtomCookie = xcb_intern_atom(connection, 1, sizeof(clientListAtomName) - 1, clientListAtomName);
+    auto pidAtom = GetXcbAtomReply(connection, pidAtomCookie);
+    auto clientListAtom = GetXcbAtomReply(connection, clientListAtomCookie);
+    _XcbClientListAtom = clientListAtom;
+
+    if (pidAtom == XCB_ATOM_NONE)
+        return {};
+
+    // Try the window manager managed windows first, it's way smaller than the whole tree.
+    if (clientListAtom != XCB_ATOM_NONE)
+    {
+        auto reply = xcb_get_property_reply(connection, xcb_get_property(connection, 0, _XcbRootWindow, clientListAtom, XCB_ATOM_WINDOW, 0, UINT32_MAX / 4), nullptr);
+        if (reply != nullptr)
+        {
+            if (reply->format == 32)
+            {
+                auto clientWindows = reinterpret_cast<xcb_window_t*>(xcb_get_property_value(reply));
+                std::vector<xcb_window_t> windows(clientWindows, clientWindows + xcb_get_property_value_length(reply) / sizeof(xcb_window_t));
+                FilterXcbWindowsByPid(connection, windows, pidAtom, processId, _ApplicationWindows);
+            }
+            free(reply);
+        }
+    }
+
+    // No window manager or the window is not managed, search the tree.
+    if (_ApplicationWindows.empty())
+        FindXcbWindowsInTree(connection, _XcbRootWindow, pidAtom, processId, _ApplicationWindows);
+
+    const uint32_t eventMask = XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+    for (auto window : _ApplicationWindows)
+        xcb_change_window_attributes(connection, (xcb_window_t)window, XCB_CW_EVENT_MASK, &eventMask);
+
+    xcb_flush(connection);
+
+    return _ApplicationWindows;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -339,12 +815,74 @@ bool IgnoreEvent(XEvent &event)
     return false;
 }
 
+static inline bool IsWheelEvent(XEvent const& event)
+{
+    // Buttons 4 and 5 are the vertical wheel, 6 and 7 the horizontal one.
+    return (event.type == ButtonPress || event.type == ButtonRelease) && event.xbutton.button >= Button4 && event.xbutton.button <= 7;
+}
+
+// Consumes the event at the head of the queue if ImGui doesn't need to see it on its own.
+// Only called while the overlay owns the inputs, so consumed events never reach the application.
+bool X11Hook_t::_CoalesceEvent(Display* d, XEvent& event)
+{
+    if (event.type == MotionNotify)
+    {
+        XEvent nextEvent;
+        XNextEvent(d, &event);
+        XPeekEvent(d, &nextEvent);
+        if (nextEvent.type == MotionNotify && nextEvent.xmotion.window == event.xmotion.window)
+        {
+            // Only the last position of a motion run matters, drop this one.
+            _CoalescedEventCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        XPutBackEvent(d, &event);
+        return false;
+    }
+
+    if (_CoalesceScrollEvents.load(std::memory_order_relaxed) && IsWheelEvent(event))
+    {
+        XNextEvent(d, &event);
+        if (event.type == ButtonPress)
+        {
+            switch (event.xbutton.button)
+            {
+                case Button4: _PendingWheelY += 1.0f; break;
+                case Button5: _PendingWheelY -= 1.0f; break;
+                case 6      : _PendingWheelX += 1.0f; break;
+                case 7      : _PendingWheelX -= 1.0f; break;
+            }
+        }
+        _CoalescedEventCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+void X11Hook_t::_FlushCoalescedEvents()
+{
+    if (_PendingWheelX == 0.0f && _PendingWheelY == 0.0f)
+        return;
+
+    ImGui::GetIO().AddMouseWheelEvent(_PendingWheelX, _PendingWheelY);
+    _PendingWheelX = 0.0f;
+    _PendingWheelY = 0.0f;
+}
+
 int X11Hook_t::_CheckForOverlay(Display *d, int num_events)
 {
     char szKey[32];
 
     if( _Initialized )
     {
+        // The input thread watches the key combination, the application events are only filtered here.
+        const bool watchedKeyCombination = _InputThreadRunning;
+        const bool threadFeedsOverlay = watchedKeyCombination && _InputThreadFeedsOverlay;
+        if (watchedKeyCombination)
+            _ConsumeKeyCombination(d);
+
         XEvent event, nextEvent;
         XEvent* pNextEvent;
         while(num_events)
@@ -354,6 +892,13 @@ int X11Hook_t::_CheckForOverlay(Display *d, int num_events)
 
             XPeekEvent(d, &event);
 
+            // Motion needs a next event to compare with, wheel events can always be merged.
+            if (!threadFeedsOverlay && hide_app_inputs && !hide_overlay_inputs && (num_events > 1 || IsWheelEvent(event)) && _CoalesceEvent(d, event))
+            {
+                --num_events;
+                continue;
+            }
+
             if (event.type == KeyRelease && num_events > 1)
             {
                 XNextEvent(d, &event);
@@ -369,7 +914,7 @@ int X11Hook_t::_CheckForOverlay(Display *d, int num_events)
             }
 
             // Is the event is a key press
-            if (event.type == KeyPress || event.type == KeyRelease)
+            if (!watchedKeyCombination && (event.type == KeyPress || event.type == KeyRelease))
             {
                 XQueryKeymap(d, szKey);
                 int key_count = 0;
@@ -406,13 +951,17 @@ int X11Hook_t::_CheckForOverlay(Display *d, int num_events)
                 }
             }
 
-            if (event.type == FocusIn || event.type == FocusOut)
+            // The input thread reports the focus and can feed ImGui itself, only filter the application events then.
+            const bool isFocusEvent = event.type == FocusIn || event.type == FocusOut;
+            if (!watchedKeyCombination && isFocusEvent)
             {
                 ImGui::GetIO().SetAppAcceptingEvents(event.type == FocusIn);
             }
 
-            if (!hide_overlay_inputs || event.type == FocusIn || event.type == FocusOut)
+            if (isFocusEvent ? !watchedKeyCombination : (!threadFeedsOverlay && !hide_overlay_inputs))
             {
+                // Keep the merged wheel delta ordered with the buttons and keys that follow it.
+                _FlushCoalescedEvents();
                 ImGui_ImplX11_EventHandler(event, pNextEvent);
             }
 
@@ -426,6 +975,8 @@ int X11Hook_t::_CheckForOverlay(Display *d, int num_events)
             XNextEvent(d, &event);
             --num_events;
         }
+
+        _FlushCoalescedEvents();
     }
     return num_events;
 }
@@ -455,7 +1006,12 @@ int X11Hook_t::MyXEventsQueued(Display *display, int mode)
 
     int res = inst->_XEventsQueued(display, mode);
 
-    if( res )
+    if (inst->_FastInputPath.load(std::memory_order_relaxed))
+    {
+        // Nothing to filter while the overlay is closed, only check the key combination watched by the input thread.
+        inst->_ConsumeKeyCombination(display);
+    }
+    else if( res )
     {
         inst->_Display = display;
         res = inst->_CheckForOverlay(display, res);
@@ -470,7 +1026,11 @@ int X11Hook_t::MyXPending(Display* display)
 
     int res = inst->_XPending(display);
 
-    if( res )
+    if (inst->_FastInputPath.load(std::memory_order_relaxed))
+    {
+        inst->_ConsumeKeyCombination(display);
+    }
+    else if( res )
     {
         inst->_Display = display;
         res = inst->_CheckForOverlay(display, res);
@@ -489,6 +1049,21 @@ X11Hook_t::X11Hook_t() :
     _KeyCombinationPushed(false),
     _ApplicationInputsHidden(false),
     _OverlayInputsHidden(true),
+    _CoalesceScrollEvents(false),
+    _CoalescedEventCount(0),
+    _PendingWheelX(0.0f),
+    _PendingWheelY(0.0f),
+    _XcbRootWindow(XCB_WINDOW_NONE),
+    _XcbClientListAtom(XCB_ATOM_NONE),
+    _ApplicationWindowsProcessId(0),
+    _InputThreadWanted(false),
+    _InputThreadFeedsOverlay(false),
+    _InputThreadRunning(false),
+    _InputThreadStopping(false),
+    _InputThreadUnavailable(false),
+    _InputEvents(512),
+    _KeyCombinationPending(false),
+    _FastInputPath(false),
     _XQueryPointer(nullptr),
     _XEventsQueued(nullptr),
     _XPending(nullptr)
@@ -500,6 +1075,7 @@ X11Hook_t::~X11Hook_t()
     INGAMEOVERLAY_INFO("X11 Hook removed");
 
     ResetRenderState(OverlayHookState::Removing);
+    _StopInputThread();
 
     _inst->UnhookAll();
     _inst = nullptr;
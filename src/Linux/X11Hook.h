@@ -20,13 +20,31 @@
 #pragma once
 
 #include "../RendererHookInternal.h"
+#include "../mpmc_bounded_queue.h"
+
+#include <thread>
+#include <atomic>
+#include <future>
 
 #include <X11/X.h> // XEvent types
 #include <X11/Xlib.h> // XEvent structure
 #include <X11/Xutil.h> // XEvent keysym
+#include <xcb/xcb.h> // Window lookup
 
 namespace InGameOverlay {
 
+struct X11HookEvent_t
+{
+    XEvent Event;
+
+    inline X11HookEvent_t()
+    {}
+
+    inline X11HookEvent_t(XEvent const& event) :
+        Event(event)
+    {}
+};
+
 class X11Hook_t :
     public BaseHook_t
 {
@@ -53,9 +71,50 @@ private:
     bool _KeyCombinationPushed;
     bool _ApplicationInputsHidden;
     bool _OverlayInputsHidden;
+    std::atomic<bool> _CoalesceScrollEvents;
+    // Written by the thread pumping the application events, read from any thread.
+    std::atomic<uint64_t> _CoalescedEventCount;
+    float _PendingWheelX;
+    float _PendingWheelY;
+
+    // Private connection used to find the application windows and watch their destruction.
+    std::shared_ptr<xcb_connection_t> _XcbConnection;
+    xcb_window_t _XcbRootWindow;
+    xcb_atom_t _XcbClientListAtom;
+    std::vector<Window> _ApplicationWindows;
+    int32_t _ApplicationWindowsProcessId;
+
+    // Input thread, watches the toggle keys through XInput2 on its own connection.
+    // It runs even when the dedicated input thread is not wanted, so the event hooks can skip the filtering while the overlay is closed.
+    // When the dedicated input thread is wanted, it also reads the overlay inputs.
+    // Set from any thread, the render thread restarts the input thread in the wanted mode.
+    std::atomic<bool> _InputThreadWanted;
+    bool _InputThreadFeedsOverlay;
+    // Only set once the thread selected its events, the event hooks rely on it to watch the key combination.
+    std::atomic<bool> _InputThreadRunning;
+    std::atomic<bool> _InputThreadStopping;
+    std::atomic<bool> _InputThreadUnavailable;
+    std::thread _InputThread;
+    // Fulfilled by the input thread once its events are selected, or when it failed to.
+    std::future<bool> _InputThreadSelected;
+    mpmc_bounded_queue<X11HookEvent_t> _InputEvents;
+    // Set by the input thread when the key combination is pressed, consumed by the application thread.
+    std::atomic<bool> _KeyCombinationPending;
+    // When set, the event hooks only check _KeyCombinationPending and skip the events filtering.
+    std::atomic<bool> _FastInputPath;
 
     // Functions
     X11Hook_t();
+    bool _CoalesceEvent(Display* d, XEvent& event);
+    void _FlushCoalescedEvents();
+    void _PollApplicationWindowsEvents();
+    void _StartInputThread(Window wnd);
+    void _CheckInputThreadStarted();
+    void _StopInputThread();
+    void _InputThreadProc(Window wnd, bool readDeviceEvents, std::promise<bool> selected);
+    void _ProcessInputThreadEvents();
+    void _UpdateInputPath();
+    bool _ConsumeKeyCombination(Display* d);
     int _CheckForOverlay(Display *d, int num_events);
 
     // Hook to X11 window messages
@@ -82,6 +141,12 @@ public:
     bool StartHook(std::function<void()>& keyCombinationCallback, ToggleKey toggleKeys[], int toggleKeysCount);
     void HideAppInputs(bool hide);
     void HideOverlayInputs(bool hide);
+    // When enabled, consecutive mouse wheel events are summed into a single ImGui wheel event.
+    void SetCoalesceScrollEvents(bool coalesce);
+    // Number of input events dropped or merged since the hook started.
+    uint64_t GetCoalescedEventCount() const { return _CoalescedEventCount.load(std::memory_order_relaxed); }
+    // Reads the overlay inputs on a dedicated thread instead of waiting for the application to poll its events.
+    bool SetDedicatedInputThread(bool enabled);
     static X11Hook_t* Inst();
     virtual const char* GetLibraryName() const;
 };
@@ -84,7 +84,7 @@ void MetalHook_t::_ResetRenderState()
         //NSViewHook_t::Inst()->_ResetRenderState();
         //ImGui::DestroyContext();
 
-        _ImageResources.clear();
+        _ClearImageResources();
 
         _MetalDevice = nil;
         
@@ -120,7 +120,7 @@ void MetalHook_t::_PrepareForOverlay(RenderPass_t& renderPass)
             ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
         }
 
-        ++_CurrentFrame;
+        _BeginFrame();
         ImGui::NewFrame();
 
         OverlayProc();
@@ -144,7 +144,8 @@ void MetalHook_t::_LoadResources()
 
 void MetalHook_t::_ReleaseResources()
 {
-
+    _RemoveReleasedImageResources(_ImageResourcesToRelease);
+    _ImageResourcesToRelease.clear();
 }
 
 void MetalHook_t::_HandleScreenshot()
@@ -249,32 +250,9 @@ void MetalHook_t::LoadFunctions(Method MTLCommandBufferRenderCommandEncoderWithD
     _MTLRenderCommandEncoderEndEncodingMethod = RenderCommandEncoderEndEncoding;
 }
 
-std::weak_ptr<RendererTexture_t> MetalHook_t::AllocImageResource()
-{
-    return std::shared_ptr<RendererTexture_t>();
-}
-
-void MetalHook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter)
+RendererTextureHandle_t MetalHook_t::AllocImageResource()
 {
-    _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void MetalHook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource)
-{
-    auto ptr = resource.lock();
-    if (ptr)
-    {
-        auto it = _ImageResources.find(ptr);
-        if (it != _ImageResources.end())
-        {
-            _ImageResources.erase(it);
-            _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t
-            {
-                std::move(ptr),
-                _CurrentFrame
-            });
-        }
-    }
+    return RendererTextureHandle_t{};
 }
 
 }// namespace InGameOverlay
\ No newline at end of file
@@ -58,8 +58,6 @@ private:
     bool _NSViewHooked;
     bool _Initialized;
     OpenGLDriver_t _OpenGLDriver;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
 
@@ -94,9 +92,7 @@ public:
     virtual RendererHookType_t GetRendererHookType() const;
     void LoadFunctions(Method openGLFlushBufferMethod, decltype(::CGLFlushDrawable)* pfnCGLFlushDrawable);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
@@ -106,7 +106,7 @@ void OpenGLHook_t::_ResetRenderState()
         //NSViewHook_t::Inst()->_ResetRenderState();
         //ImGui::DestroyContext();
 
-        _ImageResources.clear();
+        _ClearImageResources();
 
         _Initialized = false;
     }
@@ -160,7 +160,7 @@ void OpenGLHook_t::_PrepareForOverlay()
             ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
         }
 
-        ++_CurrentFrame;
+        _BeginFrame();
         ImGui::NewFrame();
 
         OverlayProc();
@@ -179,7 +179,7 @@ void OpenGLHook_t::_PrepareForOverlay()
 
 void OpenGLHook_t::_LoadResources()
 {
-    if (_ImageResourcesToLoad.empty())
+    if (!_HasImageResourcesToLoad())
         return;
 
     // Save old texture id
@@ -188,25 +188,25 @@ void OpenGLHook_t::_LoadResources()
 
     struct ValidTexture_t
     {
-        std::shared_ptr<RendererTexture_t> Resource;
+        RendererTexture_t* Resource;
         const void* Data;
+        std::shared_ptr<const void> DataOwner;
         uint32_t Width;
         uint32_t Height;
     };
 
     std::vector<ValidTexture_t> validResources;
 
-    const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-    for (size_t i = 0; i < loadParameterCount; ++i)
+    RendererTextureLoadParameter_t param;
+    for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i)
     {
-        auto& param = _ImageResourcesToLoad[i];
-        auto r = param.Resource.lock();
-        if (!r) continue;
+        auto r = GetImageResource(param.Resource);
+        if (r == nullptr) continue;
 
         validResources.push_back(ValidTexture_t{
             r,
             param.Data,
+            std::move(param.DataOwner),
             param.Width,
             param.Height
         });
@@ -227,18 +227,16 @@ void OpenGLHook_t::_LoadResources()
             glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex.Width, tex.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.Data);
 
-            tex.Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+            _ImageResourceLoaded(tex.Resource);
         }
     }
 
     glBindTexture(GL_TEXTURE_2D, oldTex);
-
-    _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(),
-        _ImageResourcesToLoad.begin() + loadParameterCount);
 }
 
 void OpenGLHook_t::_ReleaseResources()
 {
+    _RemoveReleasedImageResources(_ImageResourcesToRelease);
     _ImageResourcesToRelease.clear();
 }
 
@@ -346,12 +344,12 @@ void OpenGLHook_t::LoadFunctions(Method openGLFlushBufferMethod, decltype(::CGLF
     _CGLFlushDrawable = pfnCGLFlushDrawable;
 }
 
-std::weak_ptr<RendererTexture_t> OpenGLHook_t::AllocImageResource()
+RendererTextureHandle_t OpenGLHook_t::AllocImageResource()
 {
     GLuint texture = 0;
     glGenTextures(1, &texture);
     if (glGetError() != GL_NO_ERROR)
-        return std::weak_ptr<RendererTexture_t>{};
+        return RendererTextureHandle_t{};
 
     auto ptr = std::shared_ptr<RendererTexture_t>(new RendererTexture_t(), [](RendererTexture_t* handle)
     {
@@ -364,32 +362,7 @@ std::weak_ptr<RendererTexture_t> OpenGLHook_t::AllocImageResource()
     });
     ptr->ImGuiTextureId = static_cast<uint64_t>(texture);
 
-    _ImageResources.emplace(ptr);
-
-    return ptr;
-}
-
-void OpenGLHook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter)
-{
-    _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void OpenGLHook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource)
-{
-    auto ptr = resource.lock();
-    if (ptr)
-    {
-        auto it = _ImageResources.find(ptr);
-        if (it != _ImageResources.end())
-        {
-            _ImageResources.erase(it);
-            _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t
-            {
-                std::move(ptr),
-                _CurrentFrame
-            });
-        }
-    }
+    return _ImageResources.Insert(std::move(ptr));
 }
 
 }// namespace InGameOverlay
\ No newline at end of file
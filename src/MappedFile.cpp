@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+#include "InternalIncludes.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace InGameOverlay {
+
+#if defined(_WIN32)
+
+std::shared_ptr<const void> MapFileRange(const char* path, uint64_t offset, size_t size)
+{
+    if (path == nullptr || size == 0)
+        return nullptr;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        INGAMEOVERLAY_ERROR("Failed to open {}.", path);
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && static_cast<uint64_t>(fileSize.QuadPart) >= offset + size)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    // The mapping keeps the file open.
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        INGAMEOVERLAY_ERROR("Failed to map {}.", path);
+        return nullptr;
+    }
+
+    // Views must start on the allocation granularity.
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    uint64_t viewOffset = offset - (offset % systemInfo.dwAllocationGranularity);
+    size_t viewSize = static_cast<size_t>(offset - viewOffset) + size;
+
+    auto view = reinterpret_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(viewOffset >> 32), static_cast<DWORD>(viewOffset), viewSize));
+    CloseHandle(mapping);
+    if (view == nullptr)
+    {
+        INGAMEOVERLAY_ERROR("Failed to map {}.", path);
+        return nullptr;
+    }
+
+    return std::shared_ptr<const void>(view + (offset - viewOffset), [view](const void*)
+    {
+        UnmapViewOfFile(view);
+    });
+}
+
+#else
+
+std::shared_ptr<const void> MapFileRange(const char* path, uint64_t offset, size_t size)
+{
+    if (path == nullptr || size == 0)
+        return nullptr;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        INGAMEOVERLAY_ERROR("Failed to open {}.", path);
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || static_cast<uint64_t>(fileStat.st_size) < offset + size)
+    {
+        INGAMEOVERLAY_ERROR("{} is too small.", path);
+        close(fd);
+        return nullptr;
+    }
+
+    // Mappings must start on a page boundary.
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t viewOffset = offset - (offset % pageSize);
+    size_t viewSize = static_cast<size_t>(offset - viewOffset) + size;
+
+    void* view = mmap(nullptr, viewSize, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(viewOffset));
+    // The mapping keeps the file open.
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        INGAMEOVERLAY_ERROR("Failed to map {}.", path);
+        return nullptr;
+    }
+
+    // Read once from front to back by the upload.
+    madvise(view, viewSize, MADV_SEQUENTIAL);
+
+    return std::shared_ptr<const void>(reinterpret_cast<uint8_t*>(view) + (offset - viewOffset), [view, viewSize](const void*)
+    {
+        munmap(view, viewSize);
+    });
+}
+
+#endif
+
+}// namespace InGameOverlay
@@ -19,6 +19,11 @@
 
 #include "RendererHookInternal.h"
 #include "RendererResourceInternal.h"
+#include "RendererTiledResourceInternal.h"
+#include "KTX2.h"
+
+#include <limits>
+#include <new>
 
 namespace InGameOverlay {
 
@@ -26,8 +31,23 @@ RendererHookInternal_t::RendererHookInternal_t() :
     _ScreenshotCallback(nullptr),
     _ScreenshotCallbackUserParameter(nullptr),
     _TakeScreenshotType(ScreenshotType_t::None),
+    _LoadedImageResources(0),
+    _ResidentImageBytes(0),
+    _FrameUploads(0),
+    _FrameUploadBytes(0),
+    _NextLoadLatency(0),
+    _PendingImageUploads(0),
+    _PendingImageUploadBytes(0),
+    _NextLoadSequence(0),
+    _StagingBytes(0),
+    _ResourceStats(),
     _BatchSize(10),
-    _CurrentFrame(0)
+    _CurrentFrame(0),
+    _ImageResourcesToLoad(1024),
+    _ImageResourcesToRemove(1024),
+    _ScheduledFrame(0),
+    _TextureMemoryBudget(0),
+    _ResourceDeduplication(false)
 {
 }
 
@@ -40,6 +60,13 @@ ScreenshotType_t RendererHookInternal_t::_ScreenshotType()
     return _TakeScreenshotType;
 }
 
+void RendererHookInternal_t::_BeginFrame()
+{
+    // Every frame, the frames without loads report their counters too.
+    _PublishResourceStats();
+    ++_CurrentFrame;
+}
+
 void RendererHookInternal_t::_SendScreenshot(ScreenshotCallbackParameter_t* screenshot)
 {
     _TakeScreenshotType = ScreenshotType_t::None;
@@ -73,12 +100,448 @@ void RendererHookInternal_t::_SendScreenshot(ScreenshotCallbackParameter_t* scre
     }
 }
 
+void RendererHookInternal_t::_RemoveReleasedImageResources(std::vector<RendererTextureReleaseParameter_t>& releasedResources)
+{
+    RendererTextureHandle_t resource;
+    while (_ImageResourcesToRemove.Dequeue(resource))
+    {
+        auto r = GetImageResource(resource);
+        if (r == nullptr || (!r->Evicted && --r->References != 0))
+            continue;
+
+        if (r->Deduplicated)
+        {
+            auto it = _DeduplicatedImageResources.find(r->ContentHash);
+            if (it != _DeduplicatedImageResources.end() && it->second == resource)
+                _DeduplicatedImageResources.erase(it);
+        }
+
+        if (r->LoadStatus == RendererTextureStatus_e::Loaded)
+        {
+            --_LoadedImageResources;
+            _ResidentImageBytes -= r->MemorySize;
+        }
+        _DropPendingImageResourceLoad(r);
+        _ImageResourceUnloaded(r);
+
+        releasedResources.emplace_back(RendererTextureReleaseParameter_t{ _ImageResources.Remove(resource), _CurrentFrame });
+    }
+}
+
+// Heap and sort order, the smallest then oldest load comes last.
+static bool IsLoadAfter(ScheduledTextureLoadEntry_t const& l, ScheduledTextureLoadEntry_t const& r)
+{
+    if (l.Pixels != r.Pixels)
+        return l.Pixels > r.Pixels;
+
+    return l.QueuedFrame > r.QueuedFrame;
+}
+
+void RendererHookInternal_t::_ScheduleImageResourceLoads()
+{
+    _ScheduledFrame = _CurrentFrame;
+
+    _EvictImageResources();
+
+    RendererTextureLoadParameter_t parameter;
+    while (_ImageResourcesToLoad.Dequeue(parameter))
+    {
+        auto r = GetImageResource(parameter.Resource);
+        if (r == nullptr)
+            continue;
+
+        _DropPendingImageResourceLoad(r);
+
+        ScheduledTextureLoadEntry_t entry{ parameter.Resource, r->Priority, _CurrentFrame, uint64_t(parameter.Width) * parameter.Height, ++_NextLoadSequence };
+        ++_PendingImageUploads;
+        _PendingImageUploadBytes += GetResourceFormatSize(parameter.Format, parameter.Width, parameter.Height);
+        r->PendingLoad.reset(new ScheduledTextureLoad_t{ std::move(parameter), entry });
+
+        const auto priority = static_cast<size_t>(entry.Priority);
+        _QueuedImageResourceLoads[priority].emplace_back(entry);
+        _SmallestImageResourceLoads[priority].emplace_back(entry);
+        std::push_heap(_SmallestImageResourceLoads[priority].begin(), _SmallestImageResourceLoads[priority].end(), &IsLoadAfter);
+
+        // Drawn before its load reached the scheduler.
+        if (r->LastRequestFrame == _CurrentFrame)
+            _VisibleImageResourceLoads.emplace_back(entry);
+    }
+
+    // Only the loads drawn this frame stay visible, a load drawn again since the last frame is in twice.
+    auto end = std::remove_if(_VisibleImageResourceLoads.begin(), _VisibleImageResourceLoads.end(), [this](ScheduledTextureLoadEntry_t const& entry)
+    {
+        return !_IsImageResourceLoadPending(entry) || GetImageResource(entry.Resource)->LastRequestFrame != _CurrentFrame;
+    });
+    _VisibleImageResourceLoads.erase(end, _VisibleImageResourceLoads.end());
+
+    std::sort(_VisibleImageResourceLoads.begin(), _VisibleImageResourceLoads.end(), [](ScheduledTextureLoadEntry_t const& l, ScheduledTextureLoadEntry_t const& r)
+    {
+        if (l.Priority != r.Priority)
+            return l.Priority < r.Priority;
+
+        if (l.Pixels != r.Pixels || l.QueuedFrame != r.QueuedFrame)
+            return IsLoadAfter(l, r);
+
+        // Keeps the copies of a load next to each other.
+        return l.Sequence > r.Sequence;
+    });
+    _VisibleImageResourceLoads.erase(std::unique(_VisibleImageResourceLoads.begin(), _VisibleImageResourceLoads.end(), [](ScheduledTextureLoadEntry_t const& l, ScheduledTextureLoadEntry_t const& r)
+    {
+        return l.Sequence == r.Sequence;
+    }), _VisibleImageResourceLoads.end());
+}
+
+bool RendererHookInternal_t::_IsImageResourceLoadPending(ScheduledTextureLoadEntry_t const& entry)
+{
+    auto r = GetImageResource(entry.Resource);
+    return r != nullptr && r->PendingLoad != nullptr && r->PendingLoad->Entry.Sequence == entry.Sequence;
+}
+
+bool RendererHookInternal_t::_PopNextImageResourceLoad(ScheduledTextureLoadEntry_t& entry)
+{
+    // Frames a request can wait before it goes first, indexed by RendererResourcePriority_t.
+    static constexpr uint64_t MaxWaitFrames[ResourcePriorityCount] = { 240, 60, 15 };
+
+    // The oldest load of each priority is at the front, the oldest starved one goes first whatever its priority.
+    std::deque<ScheduledTextureLoadEntry_t>* starvedLoads = nullptr;
+    for (size_t priority = 0; priority < ResourcePriorityCount; ++priority)
+    {
+        auto& loads = _QueuedImageResourceLoads[priority];
+        while (!loads.empty() && !_IsImageResourceLoadPending(loads.front()))
+            loads.pop_front();
+
+        if (loads.empty() || (_CurrentFrame - loads.front().QueuedFrame) <= MaxWaitFrames[priority])
+            continue;
+
+        if (starvedLoads == nullptr || loads.front().QueuedFrame < starvedLoads->front().QueuedFrame)
+            starvedLoads = &loads;
+    }
+
+    if (starvedLoads != nullptr)
+    {
+        entry = starvedLoads->front();
+        starvedLoads->pop_front();
+        return true;
+    }
+
+    // A visible load goes before the hidden ones of its priority, but after the hidden ones of a higher priority.
+    for (size_t priority = ResourcePriorityCount; priority-- > 0;)
+    {
+        while (!_VisibleImageResourceLoads.empty())
+        {
+            auto& visibleLoad = _VisibleImageResourceLoads.back();
+            if (!_IsImageResourceLoadPending(visibleLoad))
+            {
+                _VisibleImageResourceLoads.pop_back();
+                continue;
+            }
+
+            if (static_cast<size_t>(visibleLoad.Priority) != priority)
+                break;
+
+            entry = visibleLoad;
+            _VisibleImageResourceLoads.pop_back();
+            return true;
+        }
+
+        auto& loads = _SmallestImageResourceLoads[priority];
+        while (!loads.empty())
+        {
+            std::pop_heap(loads.begin(), loads.end(), &IsLoadAfter);
+            entry = loads.back();
+            loads.pop_back();
+
+            if (_IsImageResourceLoadPending(entry))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void RendererHookInternal_t::_DropPendingImageResourceLoad(RendererTexture_t* texture)
+{
+    if (texture->PendingLoad == nullptr)
+        return;
+
+    auto const& parameter = texture->PendingLoad->Parameter;
+    --_PendingImageUploads;
+    _PendingImageUploadBytes -= GetResourceFormatSize(parameter.Format, parameter.Width, parameter.Height);
+    // Its scheduler entries don't match anything anymore, they are skipped.
+    texture->PendingLoad.reset();
+}
+
+void RendererHookInternal_t::_PublishResourceStats()
+{
+    RendererResourceStats_t stats{};
+    stats.Textures = static_cast<uint32_t>(_ImageResources.Size());
+    stats.LoadedTextures = _LoadedImageResources;
+    stats.ResidentBytes = _ResidentImageBytes;
+    stats.PendingUploads = _PendingImageUploads;
+    stats.PendingUploadBytes = _PendingImageUploadBytes;
+
+    _GetDescriptorUsage(stats.UsedDescriptors, stats.DescriptorCapacity);
+
+    stats.FrameUploads = _FrameUploads;
+    stats.FrameUploadBytes = _FrameUploadBytes;
+    _FrameUploads = 0;
+    _FrameUploadBytes = 0;
+
+    std::lock_guard<std::mutex> lock(_ResourceStatsMutex);
+    if (stats.FrameUploads == 0)
+    {
+        // No new sample, keep the last percentiles.
+        stats.LoadLatencyP50 = _ResourceStats.LoadLatencyP50;
+        stats.LoadLatencyP90 = _ResourceStats.LoadLatencyP90;
+        stats.LoadLatencyP99 = _ResourceStats.LoadLatencyP99;
+    }
+    else
+    {
+        auto latencies = _LoadLatencies;
+        auto percentile = [&latencies](size_t percent)
+        {
+            auto it = latencies.begin() + (latencies.size() - 1) * percent / 100;
+            std::nth_element(latencies.begin(), it, latencies.end());
+            return *it;
+        };
+        stats.LoadLatencyP50 = percentile(50);
+        stats.LoadLatencyP90 = percentile(90);
+        stats.LoadLatencyP99 = percentile(99);
+    }
+    _ResourceStats = stats;
+}
+
+void RendererHookInternal_t::_EvictImageResources()
+{
+    // A zero budget only removes the user limit, the driver headroom still applies.
+    auto budget = _TextureMemoryBudget == 0 ? std::numeric_limits<uint64_t>::max() : _TextureMemoryBudget;
+    uint64_t headroom;
+    auto hasHeadroom = _GetTextureMemoryHeadroom(headroom);
+    if (!hasHeadroom && budget == std::numeric_limits<uint64_t>::max())
+        return;
+
+    struct EvictionCandidate_t
+    {
+        RendererTextureHandle_t Handle;
+        uint64_t LastRequestFrame;
+        uint64_t MemorySize;
+    };
+
+    std::vector<EvictionCandidate_t> candidates;
+    uint64_t memoryUsage = 0;
+
+    _ImageResources.ForEachWithHandle([&](RendererTextureHandle_t handle, std::shared_ptr<RendererTexture_t>& texture)
+    {
+        if (texture->LoadStatus != RendererTextureStatus_e::Loaded)
+            return;
+
+        memoryUsage += texture->MemorySize;
+        if (texture->Evicted || texture->LastRequestFrame == _CurrentFrame)
+            return;
+
+        // Every resource sharing it must be able to load it again, the released ones don't count.
+        auto restorable = std::all_of(texture->LoadStates.begin(), texture->LoadStates.end(), [](std::shared_ptr<RendererTextureLoadState_t> const& loadState)
+        {
+            return loadState.use_count() == 1 || loadState->Restorable.load(std::memory_order_relaxed);
+        });
+        if (restorable)
+            candidates.emplace_back(EvictionCandidate_t{ handle, texture->LastRequestFrame, texture->MemorySize });
+    });
+
+    if (hasHeadroom)
+        budget = std::min(budget, memoryUsage + headroom);
+
+    if (memoryUsage <= budget)
+        return;
+
+    std::sort(candidates.begin(), candidates.end(), [](EvictionCandidate_t const& l, EvictionCandidate_t const& r)
+    {
+        return l.LastRequestFrame < r.LastRequestFrame;
+    });
+
+    for (auto const& candidate : candidates)
+    {
+        if (memoryUsage <= budget)
+            break;
+
+        // The resources see their handle go stale and load their data again when drawn.
+        GetImageResource(candidate.Handle)->Evicted = true;
+        _ImageResourcesToRemove.Enqueue(candidate.Handle);
+        memoryUsage -= candidate.MemorySize;
+    }
+}
+
+bool RendererHookInternal_t::_GetTextureMemoryHeadroom(uint64_t&)
+{
+    return false;
+}
+
+bool RendererHookInternal_t::_SupportsResourceFormat(RendererResourceFormat_t format)
+{
+    return format == RendererResourceFormat_t::RGBA8;
+}
+
+bool RendererHookInternal_t::_SupportsResourceMipLevels()
+{
+    return false;
+}
+
+bool RendererHookInternal_t::_GetDescriptorUsage(uint32_t&, uint32_t&)
+{
+    return false;
+}
+
+void RendererHookInternal_t::_ClearImageResources()
+{
+    _ImageResources.ForEach([this](std::shared_ptr<RendererTexture_t>& texture)
+    {
+        _ImageResourceUnloaded(texture.get());
+    });
+    _ImageResources.Clear();
+    _LoadedImageResources = 0;
+    _ResidentImageBytes = 0;
+    _ClearScheduledImageResourceLoads();
+}
+
+void RendererHookInternal_t::_ReserveImageResources(uint32_t)
+{
+}
+
+bool RendererHookInternal_t::_HasImageResourcesToLoad()
+{
+    if (_ScheduledFrame != _CurrentFrame)
+        _ScheduleImageResourceLoads();
+
+    return _PendingImageUploads != 0;
+}
+
+bool RendererHookInternal_t::_NextImageResourceToLoad(RendererTextureLoadParameter_t& loadParameter)
+{
+    if (_ScheduledFrame != _CurrentFrame)
+        _ScheduleImageResourceLoads();
+
+    ScheduledTextureLoadEntry_t entry;
+    for (;;)
+    {
+        if (!_PopNextImageResourceLoad(entry))
+            return false;
+
+        auto r = GetImageResource(entry.Resource);
+        loadParameter = std::move(r->PendingLoad->Parameter);
+        _DropPendingImageResourceLoad(r);
+
+        if (_SupportsResourceFormat(loadParameter.Format))
+            break;
+
+        // Nothing can be shown for it, the resource doesn't ask for it again.
+        if (IsResourceFormatCompressed(loadParameter.Format))
+        {
+            INGAMEOVERLAY_ERROR("The renderer can't sample this compressed format.");
+            r->LoadStatus = RendererTextureStatus_e::Failed;
+            continue;
+        }
+
+        auto pixels = std::make_shared<std::vector<uint8_t>>(ConvertResourceFormatToRGBA8(loadParameter.Format, loadParameter.Data, loadParameter.Width, loadParameter.Height));
+        loadParameter.Data = pixels->data();
+        loadParameter.DataOwner = std::shared_ptr<const void>(std::move(pixels), loadParameter.Data);
+        loadParameter.StagingBuffer = nullptr;
+        loadParameter.Format = RendererResourceFormat_t::RGBA8;
+        // Only the first level is expanded.
+        loadParameter.MipLevels.clear();
+        break;
+    }
+
+    if (!_SupportsResourceMipLevels())
+        loadParameter.MipLevels.clear();
+
+    uint64_t size = GetResourceFormatSize(loadParameter.Format, loadParameter.Width, loadParameter.Height);
+    for (auto const& level : loadParameter.MipLevels)
+        size += GetResourceFormatSize(loadParameter.Format, level.Width, level.Height);
+
+    GetImageResource(loadParameter.Resource)->MemorySize = size;
+
+    // Only the dispatched loads count, the rejected ones never reach the renderer.
+    auto latency = static_cast<uint32_t>(_CurrentFrame - entry.QueuedFrame);
+    if (_LoadLatencies.size() < LoadLatencySamples)
+        _LoadLatencies.emplace_back(latency);
+    else
+        _LoadLatencies[_NextLoadLatency] = latency;
+    _NextLoadLatency = (_NextLoadLatency + 1) % LoadLatencySamples;
+
+    ++_FrameUploads;
+    _FrameUploadBytes += size;
+    return true;
+}
+
+void RendererHookInternal_t::_ClearImageResourcesToLoad()
+{
+    _ImageResourcesToLoad.Clear();
+    _ImageResources.ForEach([](std::shared_ptr<RendererTexture_t>& texture)
+    {
+        texture->PendingLoad.reset();
+    });
+    _ClearScheduledImageResourceLoads();
+}
+
+void RendererHookInternal_t::_ClearScheduledImageResourceLoads()
+{
+    for (size_t priority = 0; priority < ResourcePriorityCount; ++priority)
+    {
+        _QueuedImageResourceLoads[priority].clear();
+        _SmallestImageResourceLoads[priority].clear();
+    }
+    _VisibleImageResourceLoads.clear();
+    _PendingImageUploads = 0;
+    _PendingImageUploadBytes = 0;
+}
+
+void RendererHookInternal_t::_ImageResourceLoaded(RendererTexture_t* texture)
+{
+    texture->LoadStatus = RendererTextureStatus_e::Loaded;
+    ++_LoadedImageResources;
+    _ResidentImageBytes += texture->MemorySize;
+
+    for (auto& loadState : texture->LoadStates)
+        loadState->Loaded.store(true, std::memory_order_release);
+
+    auto notifications = std::move(texture->LoadedNotifications);
+    texture->LoadedNotifications.clear();
+    for (auto& notification : notifications)
+    {
+        if (notification->PendingTextures.fetch_sub(1, std::memory_order_acq_rel) == 1 && !notification->Cancelled.load(std::memory_order_acquire))
+            notification->Callback(notification->Resource, notification->UserParameter);
+    }
+}
+
+void RendererHookInternal_t::_ImageResourceUnloaded(RendererTexture_t* texture)
+{
+    for (auto& loadState : texture->LoadStates)
+        loadState->Loaded.store(false, std::memory_order_release);
+
+    texture->LoadStates.clear();
+}
+
 void RendererHookInternal_t::SetScreenshotCallback(ScreenshotCallback_t callback, void* userParam)
 {
     _ScreenshotCallback = callback;
     _ScreenshotCallbackUserParameter = userParam;
 }
 
+bool RendererHookInternal_t::SetDedicatedInputThread(bool)
+{
+    return false;
+}
+
+bool RendererHookInternal_t::SetCoalesceScrollEvents(bool)
+{
+    return false;
+}
+
+uint64_t RendererHookInternal_t::GetCoalescedInputEventCount()
+{
+    return 0;
+}
+
 uint32_t RendererHookInternal_t::GetAutoLoadBatchSize()
 {
     return _BatchSize;
@@ -89,6 +552,44 @@ void RendererHookInternal_t::SetAutoLoadBatchSize(uint32_t batchSize)
     _BatchSize = batchSize;
 }
 
+uint64_t RendererHookInternal_t::GetTextureMemoryBudget()
+{
+    return _TextureMemoryBudget;
+}
+
+void RendererHookInternal_t::SetTextureMemoryBudget(uint64_t budget)
+{
+    _TextureMemoryBudget = budget;
+}
+
+bool RendererHookInternal_t::GetResourceDeduplication()
+{
+    return _ResourceDeduplication;
+}
+
+void RendererHookInternal_t::SetResourceDeduplication(bool enabled)
+{
+    _ResourceDeduplication = enabled;
+}
+
+const char* RendererHookInternal_t::GetResourceCacheDirectory()
+{
+    return _ResourceCacheDirectory.c_str();
+}
+
+void RendererHookInternal_t::SetResourceCacheDirectory(const char* path)
+{
+    _ResourceCacheDirectory = path == nullptr ? "" : path;
+}
+
+RendererResourceStats_t RendererHookInternal_t::GetResourceStats()
+{
+    std::lock_guard<std::mutex> lock(_ResourceStatsMutex);
+    auto stats = _ResourceStats;
+    stats.StagingBytes = _StagingBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void RendererHookInternal_t::TakeScreenshot(ScreenshotType_t type)
 {
     _TakeScreenshotType = type;
@@ -108,4 +609,204 @@ RendererResource_t* RendererHookInternal_t::CreateAndAttachResource(const void*
     return pResource;
 }
 
+bool RendererHookInternal_t::CreateResources(uint32_t count, RendererResourceDesc_t const* descs, RendererResource_t** resources)
+{
+    if (count == 0 || descs == nullptr || resources == nullptr)
+        return false;
+
+    // Freed when the last resource of the pool is deleted.
+    auto pool = std::shared_ptr<void>(::operator new(sizeof(RendererResourceInternal_t) * count, std::nothrow), [](void* storage) { ::operator delete(storage); });
+    if (pool == nullptr)
+        return false;
+
+    auto storage = static_cast<RendererResourceInternal_t*>(pool.get());
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto pResource = new (storage + i) RendererResourceInternal_t(this, pool);
+        pResource->SetPriority(descs[i].Priority);
+        if (descs[i].Data != nullptr)
+            pResource->AttachResource(descs[i].Data, descs[i].Width, descs[i].Height, descs[i].Format);
+
+        resources[i] = pResource;
+    }
+
+    _ReserveImageResources(count);
+    return true;
+}
+
+RendererResource_t* RendererHookInternal_t::CreateResourceFromEncoded(const void* encoded_data, size_t encoded_size)
+{
+    auto pResource = new RendererResourceInternal_t(this);
+    pResource->AttachDecodedImage(_ImageDecodePool.DecodeFromMemory(encoded_data, encoded_size, _ResourceCacheDirectory));
+
+    return pResource;
+}
+
+RendererResource_t* RendererHookInternal_t::CreateResourceFromFile(const char* path)
+{
+    auto pResource = new RendererResourceInternal_t(this);
+    pResource->AttachDecodedImage(DecodeImageFromFile(path));
+
+    return pResource;
+}
+
+RendererResource_t* RendererHookInternal_t::CreateResourceFromKTX2(const void* data, size_t size)
+{
+    RendererResourceFormat_t format;
+    std::vector<RendererTextureLevel_t> levels;
+    if (!ParseKTX2(data, size, format, levels))
+        return nullptr;
+
+    if (!IsResourceFormatSupported(format))
+    {
+        INGAMEOVERLAY_ERROR("The renderer can't sample the KTX2 format.");
+        return nullptr;
+    }
+
+    // The levels are rebased on the copy, it is released once they are all uploaded.
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    auto buffer = std::make_shared<std::vector<uint8_t>>(bytes, bytes + size);
+    for (auto& level : levels)
+        level.Data = buffer->data() + (reinterpret_cast<const uint8_t*>(level.Data) - bytes);
+
+    auto pResource = new RendererResourceInternal_t(this);
+    pResource->AttachResourceLevels(std::move(buffer), std::move(levels), format);
+
+    return pResource;
+}
+
+bool RendererHookInternal_t::IsResourceFormatSupported(RendererResourceFormat_t format)
+{
+    return !IsResourceFormatCompressed(format) || _SupportsResourceFormat(format);
+}
+
+RendererTiledResource_t* RendererHookInternal_t::CreateTiledResource(uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheTiles, RendererTileProviderCallback_t provider, void* userParameter)
+{
+    if (width == 0 || height == 0 || tileSize == 0 || cacheTiles == 0 || provider == nullptr)
+        return nullptr;
+
+    return new RendererTiledResourceInternal_t(this, width, height, tileSize, cacheTiles, provider, userParameter);
+}
+
+RendererTextureHandle_t RendererHookInternal_t::AcquireDeduplicatedImageResource(uint64_t contentHash)
+{
+    auto it = _DeduplicatedImageResources.find(contentHash);
+    if (it != _DeduplicatedImageResources.end())
+    {
+        // Can be stale after a device reset.
+        auto r = GetImageResource(it->second);
+        if (r != nullptr)
+        {
+            ++r->References;
+            return it->second;
+        }
+    }
+
+    auto handle = AllocImageResource();
+    auto r = GetImageResource(handle);
+    if (r != nullptr)
+    {
+        r->Deduplicated = true;
+        r->ContentHash = contentHash;
+        _DeduplicatedImageResources[contentHash] = handle;
+    }
+
+    return handle;
+}
+
+void RendererHookInternal_t::RequestImageResource(RendererTexture_t* texture)
+{
+    if (texture->LastRequestFrame == _CurrentFrame)
+        return;
+
+    texture->LastRequestFrame = _CurrentFrame;
+    if (texture->PendingLoad != nullptr)
+        _VisibleImageResourceLoads.emplace_back(texture->PendingLoad->Entry);
+}
+
+std::shared_ptr<RendererTextureLoadState_t> RendererHookInternal_t::TrackImageResourceLoad(RendererTexture_t* texture)
+{
+    // Drops the states of the resources that moved to another texture.
+    texture->LoadStates.erase(std::remove_if(texture->LoadStates.begin(), texture->LoadStates.end(), [](std::shared_ptr<RendererTextureLoadState_t> const& loadState)
+    {
+        return loadState.use_count() == 1;
+    }), texture->LoadStates.end());
+
+    auto loadState = std::make_shared<RendererTextureLoadState_t>();
+    loadState->Loaded.store(texture->LoadStatus == RendererTextureStatus_e::Loaded, std::memory_order_release);
+    texture->LoadStates.emplace_back(loadState);
+    return loadState;
+}
+
+std::shared_ptr<DecodedImage_t> RendererHookInternal_t::DecodeImageFromFile(const char* path)
+{
+    return _ImageDecodePool.DecodeFromFile(path, _ResourceCacheDirectory);
+}
+
+std::shared_ptr<ImagePreview_t> RendererHookInternal_t::MakePreview(const void* pixels, uint32_t width, uint32_t height, std::shared_ptr<const void> pixelsOwner)
+{
+    return _ImageDecodePool.MakePreview(pixels, width, height, std::move(pixelsOwner));
+}
+
+std::shared_ptr<PixelsHash_t> RendererHookInternal_t::HashPixels(const void* pixels, uint32_t width, uint32_t height, RendererResourceFormat_t format, std::shared_ptr<const void> pixelsOwner)
+{
+    return _ImageDecodePool.HashPixels(pixels, width, height, format, std::move(pixelsOwner));
+}
+
+std::shared_ptr<RendererStagingBuffer_t> RendererHookInternal_t::AllocStagingBuffer(uint32_t width, uint32_t height)
+{
+    auto buffer = _AllocStagingBuffer(width, height);
+    if (buffer == nullptr)
+        return nullptr;
+
+    const uint64_t size = uint64_t(buffer->Pitch) * height;
+    _StagingBytes.fetch_add(size, std::memory_order_relaxed);
+
+    auto stagingBuffer = buffer.get();
+    return std::shared_ptr<RendererStagingBuffer_t>(stagingBuffer, [this, size, buffer](RendererStagingBuffer_t*) mutable
+    {
+        buffer.reset();
+        _StagingBytes.fetch_sub(size, std::memory_order_relaxed);
+    });
+}
+
+std::shared_ptr<RendererStagingBuffer_t> RendererHookInternal_t::_AllocStagingBuffer(uint32_t width, uint32_t height)
+{
+    struct HeapStagingBuffer_t : RendererStagingBuffer_t
+    {
+        std::vector<uint8_t> Pixels;
+    };
+
+    auto buffer = std::make_shared<HeapStagingBuffer_t>();
+    buffer->Pixels.resize(size_t(width) * size_t(height) * 4);
+    buffer->Data = buffer->Pixels.data();
+    buffer->Pitch = width * 4;
+    return buffer;
+}
+
+void RendererHookInternal_t::ReserveImageResources(uint32_t count)
+{
+    _ReserveImageResources(count);
+}
+
+void RendererHookInternal_t::EndStagingWrite(RendererStagingBuffer_t& buffer)
+{
+    _EndStagingWrite(buffer);
+}
+
+void RendererHookInternal_t::_EndStagingWrite(RendererStagingBuffer_t&)
+{
+}
+
+void RendererHookInternal_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter)
+{
+    _ImageResourcesToLoad.Enqueue(loadParameter);
+}
+
+void RendererHookInternal_t::ReleaseImageResource(RendererTextureHandle_t resource)
+{
+    if (resource.IsValid())
+        _ImageResourcesToRemove.Enqueue(resource);
+}
+
 }
\ No newline at end of file
@@ -21,8 +21,15 @@
 
 #include <InGameOverlay/RendererHook.h>
 #include "InternalIncludes.h"
+#include "SlotMap.h"
+#include "ResourceQueue.h"
+#include "ImageDecoder.h"
+#include "ResourceFormat.h"
 
+#include <mutex>
+#include <deque>
 #include <set>
+#include <unordered_map>
 #include <memory>
 #include <algorithm>
 
@@ -33,20 +40,91 @@ enum class RendererTextureStatus_e
     NotLoaded,
     Loading,
     Loaded,
+    // The renderer can't upload its format, it is not requested again.
+    Failed,
 };
 
-struct RendererTexture_t
+struct RendererTextureLoadedNotification_t
 {
-    uint64_t ImGuiTextureId = 0;
-    RendererTextureStatus_e LoadStatus = RendererTextureStatus_e::NotLoaded;
+    RendererResourceLoadedCallback_t Callback = nullptr;
+    void* UserParameter = nullptr;
+    RendererResource_t* Resource = nullptr;
+    // Textures left to load, the callback is called by the last one.
+    std::atomic<uint32_t> PendingTextures{ 0 };
+    std::atomic<bool> Cancelled{ false };
+};
+
+// Shared by a resource and the texture it loads, the renderer thread publishes the load there instead of the resource reading the textures.
+struct RendererTextureLoadState_t
+{
+    std::atomic<bool> Loaded{ false };
+    // The resource can load its pixels again if the texture is evicted.
+    std::atomic<bool> Restorable{ false };
+};
+
+using RendererTextureHandle_t = SlotMapHandle_t;
+
+// Memory the application writes the pixels into before they are uploaded.
+struct RendererStagingBuffer_t
+{
+    void* Data = nullptr;
+    uint32_t Pitch = 0;
+    // Data points into the renderer upload memory instead of the heap.
+    bool RendererMemory = false;
 };
 
 struct RendererTextureLoadParameter_t
 {
-    std::weak_ptr<RendererTexture_t> Resource;
+    RendererTextureHandle_t Resource;
     const void* Data;
+    // Keeps Data alive until the upload when the resource owns it.
+    std::shared_ptr<const void> DataOwner;
+    // Set when Data was written with BeginWrite, DataOwner keeps it alive.
+    RendererStagingBuffer_t* StagingBuffer = nullptr;
     uint32_t Height;
     uint32_t Width;
+    RendererResourceFormat_t Format = RendererResourceFormat_t::RGBA8;
+    // Levels after Data, kept alive by DataOwner too. Dropped for the renderers without mipmaps.
+    std::vector<RendererTextureLevel_t> MipLevels;
+};
+
+// Where a pending load stands in the scheduler, the load itself is kept on its texture.
+struct ScheduledTextureLoadEntry_t
+{
+    RendererTextureHandle_t Resource;
+    RendererResourcePriority_t Priority;
+    uint64_t QueuedFrame;
+    uint64_t Pixels;
+    // The entries of an older load of the texture don't match it, they are skipped.
+    uint64_t Sequence;
+};
+
+struct ScheduledTextureLoad_t
+{
+    RendererTextureLoadParameter_t Parameter;
+    ScheduledTextureLoadEntry_t Entry;
+};
+
+struct RendererTexture_t
+{
+    uint64_t ImGuiTextureId = 0;
+    RendererTextureStatus_e LoadStatus = RendererTextureStatus_e::NotLoaded;
+    RendererResourcePriority_t Priority = RendererResourcePriority_t::Normal;
+    // Last frame GetResourceId was called, the texture is visible if it is the current one.
+    uint64_t LastRequestFrame = 0;
+    uint64_t MemorySize = 0;
+    // Removed to fit in the memory budget whatever its references, the resources see their handle go stale.
+    bool Evicted = false;
+    // Resources sharing this texture through the deduplication cache, it is removed when it reaches 0.
+    uint32_t References = 1;
+    bool Deduplicated = false;
+    uint64_t ContentHash = 0;
+    // Every resource that prefetched it, deduplicated textures are shared.
+    std::vector<std::shared_ptr<RendererTextureLoadedNotification_t>> LoadedNotifications;
+    // One per resource using the texture, set while it is loaded. It can only be evicted if they are all restorable.
+    std::vector<std::shared_ptr<RendererTextureLoadState_t>> LoadStates;
+    // Set while the load waits in the scheduler.
+    std::unique_ptr<ScheduledTextureLoad_t> PendingLoad;
 };
 
 struct RendererTextureReleaseParameter_t
@@ -59,39 +137,194 @@ class RendererResourceInternal_t;
 
 class RendererHookInternal_t : public RendererHook_t
 {
+    // Number of uploads the latency percentiles are computed over.
+    static constexpr size_t LoadLatencySamples = 256;
+    static constexpr size_t ResourcePriorityCount = 3;
+
     ScreenshotCallback_t _ScreenshotCallback;
     void* _ScreenshotCallbackUserParameter;
     ScreenshotType_t _TakeScreenshotType;
 
+    // Renderer thread counters, published to _ResourceStats once per frame.
+    uint32_t _LoadedImageResources;
+    uint64_t _ResidentImageBytes;
+    uint32_t _FrameUploads;
+    uint64_t _FrameUploadBytes;
+    std::vector<uint32_t> _LoadLatencies;
+    size_t _NextLoadLatency;
+    uint32_t _PendingImageUploads;
+    uint64_t _PendingImageUploadBytes;
+    uint64_t _NextLoadSequence;
+    // Renderer thread only, indexed by RendererResourcePriority_t. The pending loads in queue order, so the starved ones are at the front,
+    // and a heap with the smallest load on top. A dispatched load stays in the other one until it is skipped.
+    std::deque<ScheduledTextureLoadEntry_t> _QueuedImageResourceLoads[ResourcePriorityCount];
+    std::vector<ScheduledTextureLoadEntry_t> _SmallestImageResourceLoads[ResourcePriorityCount];
+    // The pending loads drawn this frame, they go before the hidden ones of their priority. Sorted so the next one is at the back.
+    std::vector<ScheduledTextureLoadEntry_t> _VisibleImageResourceLoads;
+    std::atomic<uint64_t> _StagingBytes;
+    std::mutex _ResourceStatsMutex;
+    RendererResourceStats_t _ResourceStats;
+
+    void _PublishResourceStats();
+
+    bool _IsImageResourceLoadPending(ScheduledTextureLoadEntry_t const& entry);
+
+    bool _PopNextImageResourceLoad(ScheduledTextureLoadEntry_t& entry);
+
+    void _ClearScheduledImageResourceLoads();
+
+    // Forgets the load waiting for this texture.
+    void _DropPendingImageResourceLoad(RendererTexture_t* texture);
+
 protected:
     uint32_t _BatchSize;
     uint64_t _CurrentFrame;
+    // Textures owned by the renderer, RendererResourceInternal_t only keeps their handle.
+    SlotMap_t<std::shared_ptr<RendererTexture_t>> _ImageResources;
+    // Filled from any thread, drained by the renderer.
+    ResourceQueue_t<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
+    ResourceQueue_t<RendererTextureHandle_t> _ImageResourcesToRemove;
+    ImageDecodePool_t _ImageDecodePool;
+    uint64_t _ScheduledFrame;
+    uint64_t _TextureMemoryBudget;
+    bool _ResourceDeduplication;
+    std::string _ResourceCacheDirectory;
+    // Content hash to the texture shared by the resources with that content.
+    std::unordered_map<uint64_t, RendererTextureHandle_t> _DeduplicatedImageResources;
 
     RendererHookInternal_t();
     virtual ~RendererHookInternal_t();
 
     ScreenshotType_t _ScreenshotType();
 
+    // Called by every renderer when it starts drawing the overlay, publishes the stats of the frame that just ended.
+    void _BeginFrame();
+
     void _SendScreenshot(ScreenshotCallbackParameter_t* screenshot);
 
+    // Takes the textures released since the last call out of _ImageResources, they are destroyed when releasedResources drops them.
+    void _RemoveReleasedImageResources(std::vector<RendererTextureReleaseParameter_t>& releasedResources);
+
+    void _ScheduleImageResourceLoads();
+
+    // Queues the least recently drawn textures for release until the loaded ones fit in the budget.
+    void _EvictImageResources();
+
+    // Free memory left to the application, if the renderer can tell.
+    virtual bool _GetTextureMemoryHeadroom(uint64_t& headroom);
+
+    // Formats the renderer uploads as they are, the others are expanded to RGBA8 first.
+    virtual bool _SupportsResourceFormat(RendererResourceFormat_t format);
+
+    // Whether the renderer uploads RendererTextureLoadParameter_t::MipLevels.
+    virtual bool _SupportsResourceMipLevels();
+
+    // Texture descriptors in use and allocated, for the renderers allocating them from pools.
+    virtual bool _GetDescriptorUsage(uint32_t& used, uint32_t& capacity);
+
+    // Called from any thread, the default buffer is heap memory.
+    virtual std::shared_ptr<RendererStagingBuffer_t> _AllocStagingBuffer(uint32_t width, uint32_t height);
+    // Called from any thread when the application is done writing the buffer, before it is released.
+    virtual void _EndStagingWrite(RendererStagingBuffer_t& buffer);
+
+    // Drops every texture, when the renderer device goes away.
+    void _ClearImageResources();
+
+    bool _HasImageResourcesToLoad();
+
+    // Returns the load requests visible and small images first, a request waiting longer than its priority allows goes first.
+    bool _NextImageResourceToLoad(RendererTextureLoadParameter_t& loadParameter);
+
+    void _ClearImageResourcesToLoad();
+
+    // Called from any thread with the number of textures CreateResources announced, for the renderers that can allocate them in one pass.
+    virtual void _ReserveImageResources(uint32_t count);
+
+    // Marks the texture as loaded and notifies the resources that prefetched it.
+    void _ImageResourceLoaded(RendererTexture_t* texture);
+
+    // The resources using the texture see it unloaded.
+    void _ImageResourceUnloaded(RendererTexture_t* texture);
+
 public:
     virtual void SetScreenshotCallback(ScreenshotCallback_t callback, void* userParam);
 
+    virtual bool SetDedicatedInputThread(bool enabled);
+    virtual bool SetCoalesceScrollEvents(bool coalesce);
+    virtual uint64_t GetCoalescedInputEventCount();
+
     virtual uint32_t GetAutoLoadBatchSize();
 
     virtual void SetAutoLoadBatchSize(uint32_t batchSize);
 
+    virtual uint64_t GetTextureMemoryBudget();
+
+    virtual void SetTextureMemoryBudget(uint64_t budget);
+
+    virtual bool GetResourceDeduplication();
+
+    virtual void SetResourceDeduplication(bool enabled);
+
+    virtual const char* GetResourceCacheDirectory();
+
+    virtual void SetResourceCacheDirectory(const char* path);
+
     virtual RendererResource_t* CreateResource();
 
     virtual RendererResource_t* CreateAndAttachResource(const void* image_data, uint32_t width, uint32_t height);
 
+    virtual bool CreateResources(uint32_t count, RendererResourceDesc_t const* descs, RendererResource_t** resources);
+
+    virtual RendererResource_t* CreateResourceFromEncoded(const void* encoded_data, size_t encoded_size);
+
+    virtual RendererResource_t* CreateResourceFromFile(const char* path);
+
+    virtual RendererResource_t* CreateResourceFromKTX2(const void* data, size_t size);
+
+    virtual bool IsResourceFormatSupported(RendererResourceFormat_t format);
+
+    virtual RendererTiledResource_t* CreateTiledResource(uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheTiles, RendererTileProviderCallback_t provider, void* userParameter);
+
     virtual void TakeScreenshot(ScreenshotType_t type);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource() = 0;
+    virtual RendererResourceStats_t GetResourceStats();
+
+    inline uint64_t GetCurrentFrame() const { return _CurrentFrame; }
+
+    inline RendererTexture_t* GetImageResource(RendererTextureHandle_t resource)
+    {
+        auto texture = _ImageResources.Get(resource);
+        return texture == nullptr ? nullptr : texture->get();
+    }
+
+    virtual RendererTextureHandle_t AllocImageResource() = 0;
+
+    // Returns the texture already holding this content, or allocates it.
+    RendererTextureHandle_t AcquireDeduplicatedImageResource(uint64_t contentHash);
+
+    // Called while drawing, the texture is visible this frame. It is not evicted and its pending load goes first.
+    void RequestImageResource(RendererTexture_t* texture);
+
+    // Returns the state the renderer thread sets once the texture is loaded, for a resource that just got the texture.
+    std::shared_ptr<RendererTextureLoadState_t> TrackImageResourceLoad(RendererTexture_t* texture);
+
+    std::shared_ptr<DecodedImage_t> DecodeImageFromFile(const char* path);
+
+    std::shared_ptr<ImagePreview_t> MakePreview(const void* pixels, uint32_t width, uint32_t height, std::shared_ptr<const void> pixelsOwner);
+
+    std::shared_ptr<PixelsHash_t> HashPixels(const void* pixels, uint32_t width, uint32_t height, RendererResourceFormat_t format, std::shared_ptr<const void> pixelsOwner);
+
+    // Called from any thread, the buffer is accounted in the resource stats until it is released.
+    std::shared_ptr<RendererStagingBuffer_t> AllocStagingBuffer(uint32_t width, uint32_t height);
+
+    void EndStagingWrite(RendererStagingBuffer_t& buffer);
+
+    // Called from any thread before creating count textures at once, like the frames of an animation.
+    void ReserveImageResources(uint32_t count);
 
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter) = 0;
+    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
 
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) = 0;
+    virtual void ReleaseImageResource(RendererTextureHandle_t resource);
 };
 
 }
\ No newline at end of file
@@ -20,13 +20,32 @@
 #include "InternalIncludes.h"
 #include "RendererHookInternal.h"
 #include "RendererResourceInternal.h"
+#include "MappedFile.h"
+#include "ResourceFormat.h"
+#include "ResourceCache.h"
+
+#include <algorithm>
+#include <new>
 
 namespace InGameOverlay {
 
 RendererResourceInternal_t::RendererResourceInternal_t(RendererHookInternal_t* rendererHook) noexcept :
     _RendererHook(rendererHook),
-    _Data(nullptr)
+    _Priority(RendererResourcePriority_t::Normal),
+    _WriteWidth(0),
+    _WriteHeight(0),
+    _StagingBuffer(nullptr),
+    _ProgressiveLoad(false),
+    _Lost(false),
+    _Data(nullptr),
+    _Format(RendererResourceFormat_t::RGBA8)
+{
+}
+
+RendererResourceInternal_t::RendererResourceInternal_t(RendererHookInternal_t* rendererHook, std::shared_ptr<void> pool) noexcept :
+    RendererResourceInternal_t(rendererHook)
 {
+    _Pool = std::move(pool);
 }
 
 RendererResourceInternal_t::~RendererResourceInternal_t()
@@ -36,67 +55,294 @@ RendererResourceInternal_t::~RendererResourceInternal_t()
 
 void RendererResourceInternal_t::Delete()
 {
-    delete this;
+    if (_Pool == nullptr)
+    {
+        delete this;
+        return;
+    }
+
+    // Constructed in place by CreateResources, the storage goes away with the last resource of the pool.
+    auto pool = std::move(_Pool);
+    this->~RendererResourceInternal_t();
 }
 
 bool RendererResourceInternal_t::IsLoaded() const
 {
-    return !_RendererResource.RendererResource.expired();
+    if (_Animation != nullptr)
+        return _PendingImage == nullptr && std::all_of(_Animation->Frames.begin(), _Animation->Frames.end(), [](RendererResourceInternal_t const* frame) { return frame->IsLoaded(); });
+
+    return _PendingImage == nullptr && _LoadState != nullptr && _LoadState->Loaded.load(std::memory_order_acquire);
+}
+
+bool RendererResourceInternal_t::IsLost() const
+{
+    return _Lost;
 }
 
 bool RendererResourceInternal_t::HasAttachedResource() const
 {
-    return _Data != nullptr;
+    if (_Data != nullptr || _PendingImage != nullptr || !_QueuedDataOwner.expired())
+        return true;
+
+    return _Animation != nullptr && std::any_of(_Animation->Frames.begin(), _Animation->Frames.end(), [](RendererResourceInternal_t const* frame) { return frame->HasAttachedResource(); });
 }
 
 uint64_t RendererResourceInternal_t::GetResourceId()
 {
-    if (HasAttachedResource())
+    if (_PendingImage != nullptr)
+        _AttachPendingImage();
+
+    if (_Animation != nullptr)
+        return _GetAnimationFrameId();
+
+    auto r = _RequestLoad();
+    if (r != nullptr)
+    {
+        _RendererHook->RequestImageResource(r);
+
+        if (r->LoadStatus == RendererTextureStatus_e::Loaded)
+        {
+            if (AttachementChanged())
+                UnloadOldResource();
+
+            _ReleasePreview();
+            return r->ImGuiTextureId;
+        }
+    }
+
+    auto preview = _RequestPreview();
+    if (preview != nullptr && preview->LoadStatus == RendererTextureStatus_e::Loaded)
+        return preview->ImGuiTextureId;
+
+    if (AttachementChanged())
+    {
+        auto r = _RendererHook->GetImageResource(_OldRendererResource.RendererResource);
+        if (r != nullptr)
+            return r->ImGuiTextureId;
+    }
+
+    return 0;
+}
+
+bool RendererResourceInternal_t::Prefetch(RendererResourceLoadedCallback_t loadedCallback, void* userParameter)
+{
+    _CancelLoadedNotification();
+
+    if (_PendingImage != nullptr)
+        _AttachPendingImage();
+
+    std::vector<RendererTexture_t*> textures;
+    if (_Animation != nullptr)
+    {
+        if (!_RequestAnimationLoad(textures))
+            return false;
+    }
+    else
     {
-        auto r = _RendererResource.RendererResource.lock();
+        auto r = _RequestLoad();
         if (r == nullptr)
+            return false;
+
+        textures.emplace_back(r);
+    }
+
+    if (loadedCallback == nullptr)
+        return true;
+
+    auto isPending = [](RendererTexture_t const* r) { return r->LoadStatus != RendererTextureStatus_e::Loaded; };
+    const auto pendingTextures = static_cast<uint32_t>(std::count_if(textures.begin(), textures.end(), isPending));
+    if (pendingTextures == 0)
+    {
+        loadedCallback(this, userParameter);
+        return true;
+    }
+
+    // An animation is loaded once all its frames are, the callback goes with the last one.
+    _LoadedNotification = std::make_shared<RendererTextureLoadedNotification_t>();
+    _LoadedNotification->Callback = loadedCallback;
+    _LoadedNotification->UserParameter = userParameter;
+    _LoadedNotification->Resource = this;
+    _LoadedNotification->PendingTextures.store(pendingTextures, std::memory_order_relaxed);
+    for (auto r : textures)
+    {
+        if (isPending(r))
+            r->LoadedNotifications.emplace_back(_LoadedNotification);
+    }
+
+    return true;
+}
+
+RendererTexture_t* RendererResourceInternal_t::_RequestLoad()
+{
+    if (_PendingImage != nullptr)
+        _AttachPendingImage();
+
+    // The texture can outlive the attached data when it was owned and released after its upload.
+    auto r = _RendererHook->GetImageResource(_RendererResource.RendererResource);
+    // Our texture went away with the renderer device, borrowed data is simply loaded again.
+    // Released owned data can only come back from a file, the application has to attach the others again.
+    if (r == nullptr && !HasAttachedResource() && _RendererResource.RendererResource.IsValid())
+        _Lost = !_RestoreSource();
+
+    if (r == nullptr && HasAttachedResource())
+    {
+        if (_PixelsHash == nullptr)
         {
             _RendererResource.RendererResource = _RendererHook->AllocImageResource();
-            r = _RendererResource.RendererResource.lock();
         }
+        else
+        {
+            if (!_PixelsHash->Done.load(std::memory_order_acquire))
+                return nullptr;
 
-        if (r != nullptr)
+            _RendererResource.RendererResource = _RendererHook->AcquireDeduplicatedImageResource(_PixelsHash->Hash);
+        }
+        r = _RendererHook->GetImageResource(_RendererResource.RendererResource);
+        _LoadState = r == nullptr ? nullptr : _RendererHook->TrackImageResourceLoad(r);
+    }
+
+    if (r == nullptr)
+        return nullptr;
+
+    r->Priority = _Priority;
+    if (_LoadState != nullptr)
+        _LoadState->Restorable.store((_Data != nullptr && _DataOwner == nullptr) || !_Source.Path.empty(), std::memory_order_relaxed);
+
+    switch (r->LoadStatus)
+    {
+        case RendererTextureStatus_e::NotLoaded:
         {
-            switch (r->LoadStatus)
+            if (_Data == nullptr)
             {
-                case RendererTextureStatus_e::NotLoaded:
+                // The renderer dropped our load and its pixels with it, like BeginWrite ones written for the previous device.
+                if (!HasAttachedResource())
                 {
-                    RendererTextureLoadParameter_t loadParameter;
-                    loadParameter.Resource = _RendererResource.RendererResource;
-                    loadParameter.Data = _Data;
-                    loadParameter.Height = _RendererResource.Height;
-                    loadParameter.Width = _RendererResource.Width;
-                    r->LoadStatus = RendererTextureStatus_e::Loading;
-                    _RendererHook->LoadImageResource(loadParameter);
+                    _RendererHook->ReleaseImageResource(_RendererResource.RendererResource);
+                    _RendererResource.RendererResource = RendererTextureHandle_t{};
+                    _LoadState.reset();
+                    _Lost = true;
+                    return nullptr;
                 }
                 break;
+            }
 
-                case RendererTextureStatus_e::Loading: break;
-                case RendererTextureStatus_e::Loaded:
-                    if (AttachementChanged())
-                        UnloadOldResource();
+            RendererTextureLoadParameter_t loadParameter;
+            loadParameter.Resource = _RendererResource.RendererResource;
+            loadParameter.Data = _Data;
+            loadParameter.DataOwner = _DataOwner;
+            loadParameter.StagingBuffer = _StagingBuffer;
+            loadParameter.Height = _RendererResource.Height;
+            loadParameter.Width = _RendererResource.Width;
+            loadParameter.Format = _Format;
+            loadParameter.MipLevels = _MipLevels;
+            r->LoadStatus = RendererTextureStatus_e::Loading;
+
+            // The other resources sharing the texture don't borrow our pixels, the load keeps its own copy
+            // in case we are released before it runs.
+            if (r->Deduplicated && _DataOwner == nullptr)
+            {
+                auto bytes = static_cast<const uint8_t*>(_Data);
+                auto pixels = std::make_shared<std::vector<uint8_t>>(bytes, bytes + GetResourceFormatSize(_Format, _RendererResource.Width, _RendererResource.Height));
+                loadParameter.Data = pixels->data();
+                loadParameter.DataOwner = std::shared_ptr<const void>(std::move(pixels), loadParameter.Data);
+            }
 
-                    return r->ImGuiTextureId;
+            // The load holds the only reference, the renderer frees the data right after the upload.
+            if (_DataOwner != nullptr)
+            {
+                _QueuedDataOwner = _DataOwner;
+                _DataOwner.reset();
+                _Data = nullptr;
+                _MipLevels.clear();
+                _StagingBuffer = nullptr;
             }
+            _RendererHook->LoadImageResource(loadParameter);
         }
+        break;
+
+        case RendererTextureStatus_e::Loading: break;
+        // Its format can't be uploaded, loading it again would fail the same way.
+        case RendererTextureStatus_e::Failed: break;
+        case RendererTextureStatus_e::Loaded:
+            // Loaded by another resource sharing the texture, our copy is not needed anymore.
+            if (_DataOwner != nullptr)
+            {
+                _DataOwner.reset();
+                _Data = nullptr;
+                _MipLevels.clear();
+                _StagingBuffer = nullptr;
+            }
+            break;
     }
-    if (AttachementChanged())
+
+    return r;
+}
+
+RendererTexture_t* RendererResourceInternal_t::_RequestPreview()
+{
+    if (_Preview == nullptr || !_Preview->Done.load(std::memory_order_acquire))
+        return nullptr;
+
+    auto r = _RendererHook->GetImageResource(_PreviewResource);
+    if (r == nullptr)
     {
-        auto r = _OldRendererResource.RendererResource.lock();
-        if (r != nullptr)
-            return r->ImGuiTextureId;
+        _PreviewResource = _RendererHook->AllocImageResource();
+        r = _RendererHook->GetImageResource(_PreviewResource);
+        if (r == nullptr)
+            return nullptr;
+
+        RendererTextureLoadParameter_t loadParameter;
+        loadParameter.Resource = _PreviewResource;
+        loadParameter.Data = _Preview->Pixels.data();
+        loadParameter.DataOwner = std::shared_ptr<const void>(_Preview, loadParameter.Data);
+        loadParameter.Height = _Preview->Height;
+        loadParameter.Width = _Preview->Width;
+        loadParameter.Format = _Format;
+        // Tiny, so it goes before the full image and lands in the first batch.
+        r->Priority = RendererResourcePriority_t::High;
+        r->LoadStatus = RendererTextureStatus_e::Loading;
+        _RendererHook->LoadImageResource(loadParameter);
     }
 
-    return 0;
+    _RendererHook->RequestImageResource(r);
+    return r;
+}
+
+void RendererResourceInternal_t::_ReleasePreview()
+{
+    if (_Preview != nullptr)
+    {
+        ImageDecodePool_t::CancelPreview(*_Preview);
+        _Preview.reset();
+    }
+
+    _RendererHook->ReleaseImageResource(_PreviewResource);
+    _PreviewResource = RendererTextureHandle_t{};
+}
+
+void RendererResourceInternal_t::_CancelPixelsHash()
+{
+    if (_PixelsHash != nullptr)
+    {
+        ImageDecodePool_t::CancelHash(*_PixelsHash);
+        _PixelsHash.reset();
+    }
+}
+
+void RendererResourceInternal_t::_CancelLoadedNotification()
+{
+    if (_LoadedNotification != nullptr)
+    {
+        _LoadedNotification->Cancelled.store(true, std::memory_order_release);
+        _LoadedNotification.reset();
+    }
 }
 
 uint32_t RendererResourceInternal_t::Width() const
 {
+    if (_Animation != nullptr)
+        return _Animation->Width;
+
     return IsLoaded()
         ? _RendererResource.Width
         : _OldRendererResource.Width;
@@ -104,41 +350,348 @@ uint32_t RendererResourceInternal_t::Width() const
 
 uint32_t RendererResourceInternal_t::Height() const
 {
+    if (_Animation != nullptr)
+        return _Animation->Height;
+
     return IsLoaded()
         ? _RendererResource.Height
         : _OldRendererResource.Height;
 }
 
-void RendererResourceInternal_t::AttachResource(const void* data, uint32_t width, uint32_t height)
+void RendererResourceInternal_t::AttachResource(const void* data, uint32_t width, uint32_t height, RendererResourceFormat_t format)
 {
-    if (IsLoaded())
+    _AttachResource(data, nullptr, width, height, format);
+}
+
+void RendererResourceInternal_t::AttachResource(void* data, size_t size, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format)
+{
+    // Released whatever happens to the buffer, even a null one may come with a user parameter to free.
+    std::shared_ptr<const void> dataOwner;
+    if (releaseCallback != nullptr)
+        dataOwner = std::shared_ptr<const void>(data, [releaseCallback, userParameter](const void* data) { releaseCallback(const_cast<void*>(data), userParameter); });
+
+    if (data == nullptr)
+    {
+        _AttachResource(nullptr, nullptr, width, height, format);
+        return;
+    }
+
+    if (size < GetResourceFormatSize(format, width, height))
+    {
+        INGAMEOVERLAY_ERROR("The attached buffer is smaller than a {}x{} image.", width, height);
+        return;
+    }
+
+    _AttachResource(data, std::move(dataOwner), width, height, format);
+}
+
+bool RendererResourceInternal_t::AttachResourceFromFile(const char* path, uint32_t width, uint32_t height, uint64_t offset, RendererResourceFormat_t format)
+{
+    auto mapping = MapFileRange(path, offset, static_cast<size_t>(GetResourceFormatSize(format, width, height)));
+    if (mapping == nullptr)
+        return false;
+
+    const void* pixels = mapping.get();
+    _AttachResource(pixels, std::move(mapping), width, height, format);
+    _Source.Path = path;
+    _Source.Offset = offset;
+    _Source.Width = width;
+    _Source.Height = height;
+    _Source.Format = format;
+    return true;
+}
+
+void* RendererResourceInternal_t::BeginWrite(uint32_t width, uint32_t height, uint32_t* pitch)
+{
+    _WriteBuffer = _RendererHook->AllocStagingBuffer(width, height);
+    if (_WriteBuffer == nullptr)
+        return nullptr;
+
+    _WriteWidth = width;
+    _WriteHeight = height;
+    if (pitch != nullptr)
+        *pitch = _WriteBuffer->Pitch;
+
+    return _WriteBuffer->Data;
+}
+
+void RendererResourceInternal_t::EndWrite()
+{
+    if (_WriteBuffer == nullptr)
+        return;
+
+    auto buffer = std::move(_WriteBuffer);
+    auto stagingBuffer = buffer.get();
+    _RendererHook->EndStagingWrite(*stagingBuffer);
+    const void* pixels = buffer->Data;
+
+    _AttachResource(pixels, std::shared_ptr<const void>(std::move(buffer), pixels), _WriteWidth, _WriteHeight, RendererResourceFormat_t::RGBA8);
+    _StagingBuffer = stagingBuffer;
+}
+
+void RendererResourceInternal_t::AttachAnimation(const void* frames, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format)
+{
+    _AttachAnimation(frames, nullptr, frameDurations, frameCount, width, height, format);
+}
+
+void RendererResourceInternal_t::AttachAnimation(void* frames, size_t size, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format)
+{
+    std::shared_ptr<const void> framesOwner;
+    if (releaseCallback != nullptr)
+        framesOwner = std::shared_ptr<const void>(frames, [releaseCallback, userParameter](const void* frames) { releaseCallback(const_cast<void*>(frames), userParameter); });
+
+    if (frames != nullptr && frameCount != 0 && size / frameCount < GetResourceFormatSize(format, width, height))
+    {
+        INGAMEOVERLAY_ERROR("The attached buffer is smaller than {} {}x{} frames.", frameCount, width, height);
+        return;
+    }
+
+    _AttachAnimation(frames, frames != nullptr ? std::move(framesOwner) : nullptr, frameDurations, frameCount, width, height, format);
+}
+
+void RendererResourceInternal_t::_AttachAnimation(const void* frames, std::shared_ptr<const void> framesOwner, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format)
+{
+    Unload();
+    if (frames == nullptr || frameDurations == nullptr || frameCount == 0)
+        return;
+
+    // The frames are constructed in one block like CreateResources does, it goes away with the last of them.
+    auto pool = std::shared_ptr<void>(::operator new(sizeof(RendererResourceInternal_t) * frameCount, std::nothrow), [](void* storage) { ::operator delete(storage); });
+    if (pool == nullptr)
+        return;
+
+    const size_t frameSize = static_cast<size_t>(GetResourceFormatSize(format, width, height));
+    auto storage = static_cast<RendererResourceInternal_t*>(pool.get());
+    _Animation.reset(new ResourceAnimation_t);
+    _Animation->Width = width;
+    _Animation->Height = height;
+    _Animation->Frames.reserve(frameCount);
+    _Animation->FrameEnds.reserve(frameCount);
+
+    uint64_t frameEnd = 0;
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        frameEnd += frameDurations[i] == 0 ? 100 : frameDurations[i];
+        _Animation->FrameEnds.emplace_back(frameEnd);
+
+        // Each frame owner shares the whole buffer, it is freed once the last frame is uploaded.
+        const void* pixels = reinterpret_cast<const uint8_t*>(frames) + frameSize * i;
+        auto frame = new (storage + i) RendererResourceInternal_t(_RendererHook, pool);
+        frame->_Priority = _Priority;
+        frame->_AttachResource(pixels, framesOwner != nullptr ? std::shared_ptr<const void>(framesOwner, pixels) : nullptr, width, height, format);
+        _Animation->Frames.emplace_back(frame);
+    }
+
+    // The renderers allocating descriptors from pools get the ones of every frame in one pass.
+    _RendererHook->ReserveImageResources(frameCount);
+}
+
+void RendererResourceInternal_t::_ClearAnimation()
+{
+    if (_Animation == nullptr)
+        return;
+
+    for (auto frame : _Animation->Frames)
+        frame->Delete();
+
+    _Animation.reset();
+}
+
+bool RendererResourceInternal_t::_RequestAnimationLoad(std::vector<RendererTexture_t*>& textures)
+{
+    bool ready = true;
+    for (auto frame : _Animation->Frames)
+    {
+        auto r = frame->_RequestLoad();
+        if (r == nullptr)
+            ready = false;
+        else
+            textures.emplace_back(r);
+    }
+
+    _Animation->LoadsRequested = ready;
+    return ready;
+}
+
+uint64_t RendererResourceInternal_t::_GetAnimationFrameId()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (!_Animation->Started)
+    {
+        _Animation->Start = now;
+        _Animation->Started = true;
+    }
+
+    const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - _Animation->Start).count()) % _Animation->FrameEnds.back();
+    const size_t currentFrame = static_cast<size_t>(std::upper_bound(_Animation->FrameEnds.begin(), _Animation->FrameEnds.end(), elapsed) - _Animation->FrameEnds.begin());
+
+    if (!_Animation->LoadsRequested)
+    {
+        std::vector<RendererTexture_t*> textures;
+        _RequestAnimationLoad(textures);
+    }
+
+    uint64_t id = 0;
+    uint64_t fallbackId = 0;
+    bool reload = false;
+    bool lost = false;
+    for (size_t i = 0; i < _Animation->Frames.size(); ++i)
+    {
+        auto frame = _Animation->Frames[i];
+        auto r = _RendererHook->GetImageResource(frame->_RendererResource.RendererResource);
+        if (r == nullptr)
+        {
+            // Evicted or gone with the renderer device, lost for good if its owned pixels are released.
+            reload = true;
+            lost |= !frame->HasAttachedResource() && frame->_RendererResource.RendererResource.IsValid();
+            continue;
+        }
+
+        // Every frame is shown in turn, so they all count as visible and none is evicted between two loops.
+        _RendererHook->RequestImageResource(r);
+        if (r->LoadStatus != RendererTextureStatus_e::Loaded)
+            continue;
+
+        // Shares a texture another resource uploaded, its copy of the pixels can go.
+        if (frame->_DataOwner != nullptr)
+            frame->_RequestLoad();
+
+        if (i == currentFrame)
+            id = r->ImGuiTextureId;
+        else if (fallbackId == 0)
+            fallbackId = r->ImGuiTextureId;
+    }
+
+    // Decodes the file again, the animation keeps playing what it has until then.
+    if (lost && _PendingImage == nullptr)
+        _Lost = !_RestoreSource();
+    else if (reload)
+        _Animation->LoadsRequested = false;
+
+    // Until the current frame is uploaded, show one that is.
+    return id != 0 ? id : fallbackId;
+}
+
+void RendererResourceInternal_t::_AttachResource(const void* data, std::shared_ptr<const void> dataOwner, uint32_t width, uint32_t height, RendererResourceFormat_t format)
+{
+    _ClearAnimation();
+
+    // Only the handle is checked here, the textures can only be looked up by the renderer thread.
+    if (_RendererResource.RendererResource.IsValid())
+    {
+        UnloadOldResource();
         _OldRendererResource = _RendererResource;
+    }
 
-    _RendererResource.RendererResource.reset();
+    _PendingImage.reset();
+    _CancelLoadedNotification();
+    _CancelPixelsHash();
+    _ReleasePreview();
+    _RendererResource.RendererResource = RendererTextureHandle_t{};
+    _LoadState.reset();
     _Data = data;
+    _DataOwner = std::move(dataOwner);
+    _QueuedDataOwner.reset();
+    _MipLevels.clear();
+    _Format = format;
+    _StagingBuffer = nullptr;
+    _Source.Reset();
+    _Lost = false;
     _RendererResource.Width = width;
     _RendererResource.Height = height;
+
+    if (_Data != nullptr && _RendererHook->GetResourceDeduplication())
+        _PixelsHash = _RendererHook->HashPixels(_Data, width, height, format, _DataOwner);
+
+    // The box filter works on 4 8 bits channels, whatever their order.
+    if (_Data != nullptr && _ProgressiveLoad && (format == RendererResourceFormat_t::RGBA8 || format == RendererResourceFormat_t::BGRA8))
+        _Preview = _RendererHook->MakePreview(_Data, width, height, _DataOwner);
 }
 
 void RendererResourceInternal_t::ClearAttachedResource()
 {
+    // The frames textures stay loaded, like a single image one.
+    if (_Animation != nullptr)
+    {
+        for (auto frame : _Animation->Frames)
+            frame->ClearAttachedResource();
+    }
+
+    _PendingImage.reset();
+    _CancelPixelsHash();
+    _ReleasePreview();
     _Data = nullptr;
+    _DataOwner.reset();
+    _QueuedDataOwner.reset();
+    _MipLevels.clear();
+    _StagingBuffer = nullptr;
+    _Source.Reset();
+
+    if (_LoadState != nullptr)
+        _LoadState->Restorable.store(false, std::memory_order_relaxed);
 }
 
 void RendererResourceInternal_t::Unload(bool clearAttachedResource)
 {
     UnloadOldResource();
+    _CancelLoadedNotification();
+    // Keeps the preview pixels if the data stays attached, only its texture goes.
+    _RendererHook->ReleaseImageResource(_PreviewResource);
+    _PreviewResource = RendererTextureHandle_t{};
 
     _RendererHook->ReleaseImageResource(_RendererResource.RendererResource);
     _RendererResource.Reset();
+    _LoadState.reset();
+    _Lost = false;
+
+    if (_Animation != nullptr)
+    {
+        if (clearAttachedResource)
+        {
+            _ClearAnimation();
+        }
+        else
+        {
+            for (auto frame : _Animation->Frames)
+                frame->Unload(false);
+        }
+    }
 
     if (clearAttachedResource)
         ClearAttachedResource();
 }
 
+void RendererResourceInternal_t::SetPriority(RendererResourcePriority_t priority)
+{
+    _Priority = priority;
+    if (_Animation != nullptr)
+    {
+        for (auto frame : _Animation->Frames)
+            frame->SetPriority(priority);
+
+        // The frames textures take the priority when their load is requested.
+        _Animation->LoadsRequested = false;
+    }
+}
+
+RendererResourcePriority_t RendererResourceInternal_t::GetPriority() const
+{
+    return _Priority;
+}
+
+void RendererResourceInternal_t::SetProgressiveLoad(bool enabled)
+{
+    _ProgressiveLoad = enabled;
+}
+
+bool RendererResourceInternal_t::GetProgressiveLoad() const
+{
+    return _ProgressiveLoad;
+}
+
 bool RendererResourceInternal_t::AttachementChanged()
 {
-    return !_OldRendererResource.RendererResource.expired();
+    return _RendererHook->GetImageResource(_OldRendererResource.RendererResource) != nullptr;
 }
 
 void RendererResourceInternal_t::UnloadOldResource()
@@ -147,4 +700,71 @@ void RendererResourceInternal_t::UnloadOldResource()
     _OldRendererResource.Reset();
 }
 
+void RendererResourceInternal_t::AttachDecodedImage(std::shared_ptr<DecodedImage_t> image)
+{
+    // Keep showing the current image until the new one is decoded.
+    _PendingImage = std::move(image);
+    _Lost = false;
+}
+
+void RendererResourceInternal_t::AttachResourceLevels(std::shared_ptr<const void> dataOwner, std::vector<RendererTextureLevel_t> levels, RendererResourceFormat_t format)
+{
+    if (levels.empty())
+        return;
+
+    _AttachResource(levels[0].Data, std::move(dataOwner), levels[0].Width, levels[0].Height, format);
+    _MipLevels.assign(levels.begin() + 1, levels.end());
+}
+
+void RendererResourceInternal_t::_AttachPendingImage()
+{
+    switch (_PendingImage->Status.load(std::memory_order_acquire))
+    {
+        case DecodeStatus_e::Pending: break;
+
+        case DecodeStatus_e::Decoded:
+        {
+            auto image = std::move(_PendingImage);
+            // Uploaded straight from the mapped cache entry, which is also where it is restored from.
+            if (!image->CachedPath.empty())
+            {
+                AttachResourceFromFile(image->CachedPath.c_str(), image->Width, image->Height, ResourceCachePixelsOffset);
+                break;
+            }
+
+            const void* pixels = image->Pixels.get();
+            if (image->FrameDurations.empty())
+                _AttachResource(pixels, std::shared_ptr<const void>(image, pixels), image->Width, image->Height, RendererResourceFormat_t::RGBA8);
+            else
+                _AttachAnimation(pixels, std::shared_ptr<const void>(image, pixels), image->FrameDurations.data(), static_cast<uint32_t>(image->FrameDurations.size()), image->Width, image->Height, RendererResourceFormat_t::RGBA8);
+
+            _Source.Path = image->Path;
+        }
+        break;
+
+        case DecodeStatus_e::Failed:
+            _PendingImage.reset();
+            break;
+    }
+}
+
+bool RendererResourceInternal_t::_RestoreSource()
+{
+    auto source = std::move(_Source);
+    _Source.Reset();
+
+    // Nothing to release, the texture is already gone.
+    _RendererResource.RendererResource = RendererTextureHandle_t{};
+    _LoadState.reset();
+
+    if (source.Path.empty())
+        return false;
+
+    if (source.Width != 0)
+        return AttachResourceFromFile(source.Path.c_str(), source.Width, source.Height, source.Offset, source.Format);
+
+    AttachDecodedImage(_RendererHook->DecodeImageFromFile(source.Path.c_str()));
+    return true;
+}
+
 }
\ No newline at end of file
@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "InternalIncludes.h"
+#include "ImageDecoder.h"
 
 namespace InGameOverlay {
 
@@ -29,30 +33,126 @@ class RendererHookInternal_t;
 
 struct ResourceState_t
 {
-    std::weak_ptr<RendererTexture_t> RendererResource;
+    RendererTextureHandle_t RendererResource;
     uint32_t Width = 0;
     uint32_t Height = 0;
 
     inline void Reset()
     {
-        RendererResource.reset();
+        RendererResource = RendererTextureHandle_t{};
         Width = 0;
         Height = 0;
     }
 };
 
+// Where the pixels can be read again once the owned data has been released.
+struct ResourceSource_t
+{
+    // Decoded again from the file, or mapped again when Width is set.
+    std::string Path;
+    uint64_t Offset = 0;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    RendererResourceFormat_t Format = RendererResourceFormat_t::RGBA8;
+
+    inline void Reset()
+    {
+        Path.clear();
+        Offset = 0;
+        Width = 0;
+        Height = 0;
+        Format = RendererResourceFormat_t::RGBA8;
+    }
+};
+
+class RendererResourceInternal_t;
+
+struct ResourceAnimation_t
+{
+    // Each frame is its own resource, so its texture is loaded, evicted and deduplicated like any other.
+    std::vector<RendererResourceInternal_t*> Frames;
+    // When each frame stops being shown, in milliseconds from the start of the loop.
+    std::vector<uint64_t> FrameEnds;
+    std::chrono::steady_clock::time_point Start;
+    bool Started = false;
+    // Every frame load was requested, the frames are only looked up until one of their textures goes away.
+    bool LoadsRequested = false;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+};
+
 class RendererResourceInternal_t : public RendererResource_t
 {
 protected:
     RendererHookInternal_t* _RendererHook;
+    // Storage shared with the other resources created by the same CreateResources call.
+    std::shared_ptr<void> _Pool;
+    // Decode in progress, attached once done.
+    std::shared_ptr<DecodedImage_t> _PendingImage;
+    RendererResourcePriority_t _Priority;
+    // Shared with the texture being loaded, cancelled when the texture is not ours anymore.
+    std::shared_ptr<RendererTextureLoadedNotification_t> _LoadedNotification;
+    // Set by the renderer thread while our texture is loaded, so IsLoaded doesn't look the texture up.
+    std::shared_ptr<RendererTextureLoadState_t> _LoadState;
+    // Set when the hook deduplicates resources, the texture is acquired once the hash is done.
+    std::shared_ptr<PixelsHash_t> _PixelsHash;
+    // Between BeginWrite and EndWrite.
+    std::shared_ptr<RendererStagingBuffer_t> _WriteBuffer;
+    uint32_t _WriteWidth;
+    uint32_t _WriteHeight;
+    // The staging buffer _Data points into, kept alive by _DataOwner.
+    RendererStagingBuffer_t* _StagingBuffer;
+    ResourceSource_t _Source;
+    bool _ProgressiveLoad;
+    // The texture went away and nothing is left to load it again from, until something is attached.
+    bool _Lost;
+    // Downscaled copy of the attached data, its texture is shown until the full one is loaded.
+    std::shared_ptr<ImagePreview_t> _Preview;
+    RendererTextureHandle_t _PreviewResource;
+    std::unique_ptr<ResourceAnimation_t> _Animation;
+
+    void _CancelPixelsHash();
+
+    RendererTexture_t* _RequestLoad();
+
+    void _CancelLoadedNotification();
+
+    RendererTexture_t* _RequestPreview();
+
+    void _ReleasePreview();
+
+    void _AttachPendingImage();
+
+    // Reads the pixels again from _Source after the renderer lost the texture, false if there is no source.
+    bool _RestoreSource();
+
+    void _AttachResource(const void* data, std::shared_ptr<const void> dataOwner, uint32_t width, uint32_t height, RendererResourceFormat_t format);
+
+    void _AttachAnimation(const void* frames, std::shared_ptr<const void> framesOwner, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format);
+
+    void _ClearAnimation();
+
+    // Requests every frame load and adds their textures, returns false if a frame has nothing to load yet.
+    bool _RequestAnimationLoad(std::vector<RendererTexture_t*>& textures);
+
+    uint64_t _GetAnimationFrameId();
 
 public:
     ResourceState_t _OldRendererResource;
     ResourceState_t _RendererResource;
     const void* _Data;
+    RendererResourceFormat_t _Format;
+    // Set when the resource owns _Data, handed to the load so it is released as soon as it is uploaded.
+    std::shared_ptr<const void> _DataOwner;
+    // The owned data held by the load, the resource still has it attached until the upload.
+    std::weak_ptr<const void> _QueuedDataOwner;
+    // The levels after _Data, when the resource was attached with its mip chain.
+    std::vector<RendererTextureLevel_t> _MipLevels;
 
     RendererResourceInternal_t(RendererHookInternal_t* rendererHook) noexcept;
 
+    RendererResourceInternal_t(RendererHookInternal_t* rendererHook, std::shared_ptr<void> pool) noexcept;
+
     RendererResourceInternal_t(RendererResourceInternal_t &&) noexcept = default;
     RendererResourceInternal_t& operator=(RendererResourceInternal_t &&) noexcept = default;
 
@@ -67,21 +167,54 @@ public:
 
     virtual bool HasAttachedResource() const;
 
+    virtual bool IsLost() const;
+
     virtual uint64_t GetResourceId();
 
+    virtual bool Prefetch(RendererResourceLoadedCallback_t loadedCallback = nullptr, void* userParameter = nullptr);
+
     virtual uint32_t Width() const;
 
     virtual uint32_t Height() const;
 
-    virtual void AttachResource(const void* data, uint32_t width, uint32_t height);
+    virtual void AttachResource(const void* data, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8);
+
+    virtual void AttachResource(void* data, size_t size, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8);
+
+    using RendererResource_t::AttachResource;
+
+    virtual bool AttachResourceFromFile(const char* path, uint32_t width, uint32_t height, uint64_t offset = 0, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8);
+
+    virtual void* BeginWrite(uint32_t width, uint32_t height, uint32_t* pitch);
+
+    virtual void EndWrite();
+
+    virtual void AttachAnimation(const void* frames, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8);
+
+    virtual void AttachAnimation(void* frames, size_t size, const uint32_t* frameDurations, uint32_t frameCount, uint32_t width, uint32_t height, RendererResourceReleaseCallback_t releaseCallback, void* userParameter, RendererResourceFormat_t format = RendererResourceFormat_t::RGBA8);
+
+    using RendererResource_t::AttachAnimation;
 
     virtual void ClearAttachedResource();
 
     virtual void Unload(bool clearAttachedResource = true);
 
+    virtual void SetPriority(RendererResourcePriority_t priority);
+
+    virtual RendererResourcePriority_t GetPriority() const;
+
+    virtual void SetProgressiveLoad(bool enabled);
+
+    virtual bool GetProgressiveLoad() const;
+
     bool AttachementChanged();
 
     void UnloadOldResource();
+
+    void AttachDecodedImage(std::shared_ptr<DecodedImage_t> image);
+
+    // Attaches a whole mip chain held by dataOwner, the full size level first.
+    void AttachResourceLevels(std::shared_ptr<const void> dataOwner, std::vector<RendererTextureLevel_t> levels, RendererResourceFormat_t format);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "RendererTiledResourceInternal.h"
+#include "RendererHookInternal.h"
+#include "RendererResourceInternal.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace InGameOverlay {
+
+RendererTiledResourceInternal_t::RendererTiledResourceInternal_t(RendererHookInternal_t* rendererHook, uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheTiles, RendererTileProviderCallback_t provider, void* userParameter) :
+    _RendererHook(rendererHook),
+    _Width(width),
+    _Height(height),
+    _TileSize(tileSize),
+    _CacheTiles(cacheTiles),
+    _LevelCount(1),
+    _Provider(provider),
+    _UserParameter(userParameter),
+    _FillFrame(0),
+    _FrameFills(0)
+{
+    while (std::max(_LevelWidth(_LevelCount - 1), _LevelHeight(_LevelCount - 1)) > _TileSize)
+        ++_LevelCount;
+}
+
+RendererTiledResourceInternal_t::~RendererTiledResourceInternal_t()
+{
+    InvalidateTiles();
+}
+
+void RendererTiledResourceInternal_t::Delete()
+{
+    delete this;
+}
+
+uint32_t RendererTiledResourceInternal_t::Width() const
+{
+    return _Width;
+}
+
+uint32_t RendererTiledResourceInternal_t::Height() const
+{
+    return _Height;
+}
+
+uint32_t RendererTiledResourceInternal_t::LevelCount() const
+{
+    return _LevelCount;
+}
+
+uint32_t RendererTiledResourceInternal_t::_LevelWidth(uint32_t level) const
+{
+    return std::max<uint32_t>(1, static_cast<uint32_t>((uint64_t(_Width) + (uint64_t(1) << level) - 1) >> level));
+}
+
+uint32_t RendererTiledResourceInternal_t::_LevelHeight(uint32_t level) const
+{
+    return std::max<uint32_t>(1, static_cast<uint32_t>((uint64_t(_Height) + (uint64_t(1) << level) - 1) >> level));
+}
+
+uint32_t RendererTiledResourceInternal_t::GetDrawQuads(float x, float y, float width, float height, float u0, float v0, float u1, float v1, RendererTileQuad_t* quads, uint32_t maxQuads)
+{
+    if (quads == nullptr || maxQuads == 0 || width <= 0.0f || height <= 0.0f)
+        return 0;
+
+    u0 = std::max(u0, 0.0f);
+    v0 = std::max(v0, 0.0f);
+    u1 = std::min(u1, 1.0f);
+    v1 = std::min(v1, 1.0f);
+    if (u1 <= u0 || v1 <= v0)
+        return 0;
+
+    // The level with about one texel per screen pixel.
+    float texelsPerPixel = std::max((u1 - u0) * _Width / width, (v1 - v0) * _Height / height);
+    uint32_t level = 0;
+    while (level + 1 < _LevelCount && texelsPerPixel >= 2.0f)
+    {
+        texelsPerPixel *= 0.5f;
+        ++level;
+    }
+
+    uint32_t firstTileX, lastTileX, firstTileY, lastTileY;
+    auto computeTileRange = [this](float start, float end, uint32_t levelSize, uint32_t& firstTile, uint32_t& lastTile)
+    {
+        const uint32_t tileCount = (levelSize + _TileSize - 1) / _TileSize;
+        firstTile = std::min(static_cast<uint32_t>(start * levelSize) / _TileSize, tileCount - 1);
+        lastTile = std::min((std::max(static_cast<uint32_t>(std::ceil(end * levelSize)), 1u) - 1) / _TileSize, tileCount - 1);
+    };
+
+    // Coarser levels are drawn while the visible tiles don't fit in the cache.
+    for (;;)
+    {
+        computeTileRange(u0, u1, _LevelWidth(level), firstTileX, lastTileX);
+        computeTileRange(v0, v1, _LevelHeight(level), firstTileY, lastTileY);
+        if (uint64_t(lastTileX - firstTileX + 1) * uint64_t(lastTileY - firstTileY + 1) <= _CacheTiles || level + 1 >= _LevelCount)
+            break;
+
+        ++level;
+    }
+
+    // Where a normalized coordinate falls in a tile, from 0 to 1.
+    auto tileCoordinate = [this](float coordinate, uint32_t levelSize, uint32_t tile)
+    {
+        const float tileStart = float(tile) * _TileSize;
+        const float tileSize = float(std::min(_TileSize, levelSize - tile * _TileSize));
+        return std::min(std::max((coordinate * levelSize - tileStart) / tileSize, 0.0f), 1.0f);
+    };
+
+    const uint32_t coarsestLevel = _LevelCount - 1;
+    const bool keepCoarsest = level != coarsestLevel && uint64_t(lastTileX - firstTileX + 1) * uint64_t(lastTileY - firstTileY + 1) < _CacheTiles;
+    // A single tile, kept as the last fallback when there is room for it.
+    if (keepCoarsest)
+        _DrawTile(coarsestLevel, 0, 0, true);
+
+    const uint32_t levelWidth = _LevelWidth(level);
+    const uint32_t levelHeight = _LevelHeight(level);
+    uint32_t quadCount = 0;
+    for (uint32_t tileY = firstTileY; tileY <= lastTileY && quadCount < maxQuads; ++tileY)
+    {
+        // The drawn part of the tile, normalized to the whole image.
+        const float top = std::max(v0, float(tileY * _TileSize) / levelHeight);
+        const float bottom = std::min(v1, float(std::min(levelHeight, (tileY + 1) * _TileSize)) / levelHeight);
+        if (bottom <= top)
+            continue;
+
+        for (uint32_t tileX = firstTileX; tileX <= lastTileX && quadCount < maxQuads; ++tileX)
+        {
+            const float left = std::max(u0, float(tileX * _TileSize) / levelWidth);
+            const float right = std::min(u1, float(std::min(levelWidth, (tileX + 1) * _TileSize)) / levelWidth);
+            if (right <= left)
+                continue;
+
+            uint32_t drawnLevel = level;
+            uint32_t drawnTileX = tileX;
+            uint32_t drawnTileY = tileY;
+            uint64_t id = _DrawTile(level, tileX, tileY, true);
+            // Until the tile is loaded, draw its part of a coarser one already loaded.
+            while (id == 0 && drawnLevel < coarsestLevel)
+            {
+                ++drawnLevel;
+                drawnTileX >>= 1;
+                drawnTileY >>= 1;
+                id = _DrawTile(drawnLevel, drawnTileX, drawnTileY, false);
+            }
+
+            if (id == 0)
+                continue;
+
+            const uint32_t drawnWidth = _LevelWidth(drawnLevel);
+            const uint32_t drawnHeight = _LevelHeight(drawnLevel);
+            auto& quad = quads[quadCount++];
+            quad.ResourceId = id;
+            quad.X0 = x + (left - u0) / (u1 - u0) * width;
+            quad.Y0 = y + (top - v0) / (v1 - v0) * height;
+            quad.X1 = x + (right - u0) / (u1 - u0) * width;
+            quad.Y1 = y + (bottom - v0) / (v1 - v0) * height;
+            quad.U0 = tileCoordinate(left, drawnWidth, drawnTileX);
+            quad.V0 = tileCoordinate(top, drawnHeight, drawnTileY);
+            quad.U1 = tileCoordinate(right, drawnWidth, drawnTileX);
+            quad.V1 = tileCoordinate(bottom, drawnHeight, drawnTileY);
+        }
+    }
+
+    return quadCount;
+}
+
+uint64_t RendererTiledResourceInternal_t::_DrawTile(uint32_t level, uint32_t tileX, uint32_t tileY, bool create)
+{
+    const uint64_t key = _TileKey(level, tileX, tileY);
+    auto it = _Tiles.find(key);
+    if (it == _Tiles.end())
+    {
+        if (!create || (_Tiles.size() >= _CacheTiles && !_EvictTile()))
+            return 0;
+
+        _LruTiles.emplace_front(key);
+        it = _Tiles.emplace(key, Tile_t{ new RendererResourceInternal_t(_RendererHook), _LruTiles.begin(), 0 }).first;
+    }
+
+    auto& tile = it->second;
+    tile.LastDrawFrame = _RendererHook->GetCurrentFrame();
+    _LruTiles.splice(_LruTiles.begin(), _LruTiles, tile.LruEntry);
+
+    uint64_t id = tile.Resource->GetResourceId();
+    // A new tile, one the provider didn't have yet, or one gone with the renderer device.
+    if (id == 0 && create && !tile.Resource->HasAttachedResource() && _FillTile(tile, level, tileX, tileY))
+        id = tile.Resource->GetResourceId();
+
+    return id;
+}
+
+bool RendererTiledResourceInternal_t::_FillTile(Tile_t& tile, uint32_t level, uint32_t tileX, uint32_t tileY)
+{
+    if (_FillFrame != _RendererHook->GetCurrentFrame())
+    {
+        _FillFrame = _RendererHook->GetCurrentFrame();
+        _FrameFills = 0;
+    }
+
+    if (_FrameFills >= MaxTileFillsPerFrame)
+        return false;
+
+    ++_FrameFills;
+
+    const uint32_t width = std::min(_TileSize, _LevelWidth(level) - tileX * _TileSize);
+    const uint32_t height = std::min(_TileSize, _LevelHeight(level) - tileY * _TileSize);
+    uint32_t pitch = 0;
+    // Written straight into the upload memory when the renderer has some.
+    void* pixels = tile.Resource->BeginWrite(width, height, &pitch);
+    if (pixels == nullptr)
+        return false;
+
+    // The write buffer is dropped by the next BeginWrite.
+    if (!_Provider(level, tileX, tileY, width, height, pixels, pitch, _UserParameter))
+        return false;
+
+    tile.Resource->EndWrite();
+    return true;
+}
+
+bool RendererTiledResourceInternal_t::_EvictTile()
+{
+    if (_LruTiles.empty())
+        return false;
+
+    auto it = _Tiles.find(_LruTiles.back());
+    if (it->second.LastDrawFrame == _RendererHook->GetCurrentFrame())
+        return false;
+
+    it->second.Resource->Delete();
+    _Tiles.erase(it);
+    _LruTiles.pop_back();
+    return true;
+}
+
+void RendererTiledResourceInternal_t::InvalidateTiles()
+{
+    for (auto& tile : _Tiles)
+        tile.second.Resource->Delete();
+
+    _Tiles.clear();
+    _LruTiles.clear();
+}
+
+}// namespace InGameOverlay
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <InGameOverlay/RendererResource.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace InGameOverlay {
+
+class RendererHookInternal_t;
+class RendererResourceInternal_t;
+
+class RendererTiledResourceInternal_t : public RendererTiledResource_t
+{
+    // Bounds the time spent in the provider by a single frame, the other tiles are asked on the next frames.
+    static constexpr uint32_t MaxTileFillsPerFrame = 16;
+
+    struct Tile_t
+    {
+        // Each tile is its own resource, so it is uploaded through the same batches as the others.
+        RendererResourceInternal_t* Resource;
+        // Position in _LruTiles, the front is the most recently drawn.
+        std::list<uint64_t>::iterator LruEntry;
+        uint64_t LastDrawFrame;
+    };
+
+    RendererHookInternal_t* _RendererHook;
+    uint32_t _Width;
+    uint32_t _Height;
+    uint32_t _TileSize;
+    uint32_t _CacheTiles;
+    uint32_t _LevelCount;
+    RendererTileProviderCallback_t _Provider;
+    void* _UserParameter;
+    std::unordered_map<uint64_t, Tile_t> _Tiles;
+    std::list<uint64_t> _LruTiles;
+    uint64_t _FillFrame;
+    uint32_t _FrameFills;
+
+    static inline uint64_t _TileKey(uint32_t level, uint32_t tileX, uint32_t tileY) { return (uint64_t(level) << 48) | (uint64_t(tileY) << 24) | uint64_t(tileX); }
+
+    uint32_t _LevelWidth(uint32_t level) const;
+
+    uint32_t _LevelHeight(uint32_t level) const;
+
+    // Returns the tile texture id, 0 until it is loaded. A tile not cached yet is only created if create is set.
+    uint64_t _DrawTile(uint32_t level, uint32_t tileX, uint32_t tileY, bool create);
+
+    bool _FillTile(Tile_t& tile, uint32_t level, uint32_t tileX, uint32_t tileY);
+
+    // Evicts the least recently drawn tile, unless every tile is drawn this frame.
+    bool _EvictTile();
+
+public:
+    RendererTiledResourceInternal_t(RendererHookInternal_t* rendererHook, uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheTiles, RendererTileProviderCallback_t provider, void* userParameter);
+
+    RendererTiledResourceInternal_t(RendererTiledResourceInternal_t const&) = delete;
+    RendererTiledResourceInternal_t& operator=(RendererTiledResourceInternal_t const&) = delete;
+
+    virtual ~RendererTiledResourceInternal_t();
+
+    virtual void Delete();
+
+    virtual uint32_t Width() const;
+
+    virtual uint32_t Height() const;
+
+    virtual uint32_t LevelCount() const;
+
+    virtual uint32_t GetDrawQuads(float x, float y, float width, float height, float u0, float v0, float u1, float v1, RendererTileQuad_t* quads, uint32_t maxQuads);
+
+    virtual void InvalidateTiles();
+};
+
+}// namespace InGameOverlay
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ResourceCache.h"
+#include "InternalIncludes.h"
+
+#include <InGameOverlay/RendererResource.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace InGameOverlay {
+
+static constexpr char ResourceCacheMagic[4] = { 'I', 'G', 'O', 'C' };
+// Bump when the entries layout changes, older entries are then decoded and written again.
+static constexpr uint32_t ResourceCacheVersion = 1;
+
+std::string GetResourceCachePath(std::string const& directory, uint64_t contentHash)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.igocache", static_cast<unsigned long long>(contentHash));
+
+    std::string path = directory;
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        path += '/';
+
+    return path + name;
+}
+
+bool ReadResourceCacheEntry(std::string const& path, uint64_t contentHash, uint32_t& width, uint32_t& height)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    ResourceCacheHeader_t header;
+    file.seekg(0, std::ios::beg);
+    if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+
+    if (memcmp(header.Magic, ResourceCacheMagic, sizeof(header.Magic)) != 0 ||
+        header.Version != ResourceCacheVersion ||
+        header.ContentHash != contentHash ||
+        header.Format != static_cast<uint32_t>(RendererResourceFormat_t::RGBA8) ||
+        header.Width == 0 || header.Height == 0 ||
+        fileSize != ResourceCachePixelsOffset + uint64_t(header.Width) * uint64_t(header.Height) * 4)
+    {
+        INGAMEOVERLAY_WARN("Ignoring invalid cache entry {}.", path);
+        return false;
+    }
+
+    width = header.Width;
+    height = header.Height;
+    return true;
+}
+
+bool WriteResourceCacheEntry(std::string const& path, uint64_t contentHash, const void* pixels, uint32_t width, uint32_t height)
+{
+    ResourceCacheHeader_t header{};
+    memcpy(header.Magic, ResourceCacheMagic, sizeof(header.Magic));
+    header.Version = ResourceCacheVersion;
+    header.ContentHash = contentHash;
+    header.Width = width;
+    header.Height = height;
+    header.Format = static_cast<uint32_t>(RendererResourceFormat_t::RGBA8);
+
+    // Unique per thread, the same image can be decoded by two workers at once.
+    const std::string temporaryPath = path + '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file ||
+            !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !file.write(reinterpret_cast<const char*>(pixels), static_cast<std::streamsize>(size_t(width) * size_t(height) * 4)))
+        {
+            INGAMEOVERLAY_WARN("Failed to write cache entry {}.", path);
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+
+    // Fails on Windows if another worker already wrote the entry, which is as good.
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+}// namespace InGameOverlay
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace InGameOverlay {
+
+// A cache entry is this header followed by the RGBA8 pixels, in a file named after the hash of the encoded image.
+struct ResourceCacheHeader_t
+{
+    char Magic[4];
+    uint32_t Version;
+    uint64_t ContentHash;
+    uint32_t Width;
+    uint32_t Height;
+    // RendererResourceFormat_t of the pixels.
+    uint32_t Format;
+    uint32_t Reserved;
+};
+
+constexpr uint64_t ResourceCachePixelsOffset = sizeof(ResourceCacheHeader_t);
+
+std::string GetResourceCachePath(std::string const& directory, uint64_t contentHash);
+
+// Checks the entry header and size, the pixels are left to be mapped.
+bool ReadResourceCacheEntry(std::string const& path, uint64_t contentHash, uint32_t& width, uint32_t& height);
+
+// Written to a temporary file first, so a concurrent reader never sees a partial entry.
+bool WriteResourceCacheEntry(std::string const& path, uint64_t contentHash, const void* pixels, uint32_t width, uint32_t height);
+
+}// namespace InGameOverlay
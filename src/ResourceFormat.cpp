@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceFormat.h"
+
+#include <cstring>
+
+namespace InGameOverlay {
+
+static float HalfToFloat(uint16_t half)
+{
+    const uint32_t sign = uint32_t(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa != 0)
+    {
+        // Denormal, normalized for the float exponent.
+        exponent = 113;
+        while (!(mantissa & 0x400))
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    else
+    {
+        bits = sign;
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static inline uint8_t FloatToUnorm8(float value)
+{
+    // Also maps NaN to 0.
+    if (!(value > 0.0f))
+        return 0;
+
+    if (value >= 1.0f)
+        return 255;
+
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+}
+
+static inline uint8_t ClampToUnorm8(int32_t value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// BT.601 limited range, 16.16 fixed point.
+static void ConvertYUV420ToRGBA8(const uint8_t* planeY, const uint8_t* planeU, const uint8_t* planeV, uint32_t chromaStep, uint32_t width, uint32_t height, uint8_t* dst)
+{
+    const uint32_t chromaWidth = (width + 1) / 2;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* rowY = planeY + size_t(y) * width;
+        const size_t chromaRow = size_t(y / 2) * chromaWidth * chromaStep;
+        for (uint32_t x = 0; x < width; ++x, dst += 4)
+        {
+            const size_t chroma = chromaRow + size_t(x / 2) * chromaStep;
+            const int32_t c = (int32_t(rowY[x]) - 16) * 76309;
+            const int32_t u = int32_t(planeU[chroma]) - 128;
+            const int32_t v = int32_t(planeV[chroma]) - 128;
+            dst[0] = ClampToUnorm8((c + 104597 * v + 32768) >> 16);
+            dst[1] = ClampToUnorm8((c - 25675 * u - 53279 * v + 32768) >> 16);
+            dst[2] = ClampToUnorm8((c + 132201 * u + 32768) >> 16);
+            dst[3] = 255;
+        }
+    }
+}
+
+bool IsResourceFormatCompressed(RendererResourceFormat_t format)
+{
+    switch (format)
+    {
+        case RendererResourceFormat_t::BC1      :
+        case RendererResourceFormat_t::BC3      :
+        case RendererResourceFormat_t::BC4      :
+        case RendererResourceFormat_t::BC5      :
+        case RendererResourceFormat_t::BC7      :
+        case RendererResourceFormat_t::ETC2RGB8 :
+        case RendererResourceFormat_t::ETC2RGBA8: return true;
+        default                                 : return false;
+    }
+}
+
+bool IsResourceFormatPlanar(RendererResourceFormat_t format)
+{
+    return format == RendererResourceFormat_t::NV12 || format == RendererResourceFormat_t::I420;
+}
+
+uint32_t GetResourceFormatPixelSize(RendererResourceFormat_t format)
+{
+    switch (format)
+    {
+        case RendererResourceFormat_t::R8     :
+        case RendererResourceFormat_t::A8     : return 1;
+        case RendererResourceFormat_t::RG8    :
+        case RendererResourceFormat_t::RGB565 : return 2;
+        case RendererResourceFormat_t::RGBA16F: return 8;
+        default                               : return 4;
+    }
+}
+
+uint64_t GetResourceFormatSize(RendererResourceFormat_t format, uint32_t width, uint32_t height)
+{
+    uint64_t blockSize;
+    switch (format)
+    {
+        case RendererResourceFormat_t::BC1      :
+        case RendererResourceFormat_t::BC4      :
+        case RendererResourceFormat_t::ETC2RGB8 : blockSize = 8; break;
+        case RendererResourceFormat_t::BC3      :
+        case RendererResourceFormat_t::BC5      :
+        case RendererResourceFormat_t::BC7      :
+        case RendererResourceFormat_t::ETC2RGBA8: blockSize = 16; break;
+        case RendererResourceFormat_t::NV12     :
+        case RendererResourceFormat_t::I420     : return uint64_t(width) * uint64_t(height) + ((uint64_t(width) + 1) / 2) * ((uint64_t(height) + 1) / 2) * 2;
+        default                                 : return uint64_t(width) * uint64_t(height) * GetResourceFormatPixelSize(format);
+    }
+
+    return ((uint64_t(width) + 3) / 4) * ((uint64_t(height) + 3) / 4) * blockSize;
+}
+
+std::vector<uint8_t> ConvertResourceFormatToRGBA8(RendererResourceFormat_t format, const void* pixels, uint32_t width, uint32_t height)
+{
+    if (IsResourceFormatCompressed(format))
+        return {};
+
+    const size_t pixelCount = size_t(width) * size_t(height);
+    std::vector<uint8_t> result(pixelCount * 4);
+    auto src = static_cast<const uint8_t*>(pixels);
+    auto dst = result.data();
+
+    switch (format)
+    {
+        case RendererResourceFormat_t::RGBA8:
+            memcpy(dst, src, result.size());
+            break;
+
+        case RendererResourceFormat_t::BGRA8:
+            for (size_t i = 0; i < pixelCount; ++i, src += 4, dst += 4)
+            {
+                dst[0] = src[2];
+                dst[1] = src[1];
+                dst[2] = src[0];
+                dst[3] = src[3];
+            }
+            break;
+
+        case RendererResourceFormat_t::R8:
+            for (size_t i = 0; i < pixelCount; ++i, ++src, dst += 4)
+            {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = 255;
+            }
+            break;
+
+        case RendererResourceFormat_t::A8:
+            for (size_t i = 0; i < pixelCount; ++i, ++src, dst += 4)
+            {
+                dst[0] = dst[1] = dst[2] = 255;
+                dst[3] = src[0];
+            }
+            break;
+
+        case RendererResourceFormat_t::RG8:
+            for (size_t i = 0; i < pixelCount; ++i, src += 2, dst += 4)
+            {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = src[1];
+            }
+            break;
+
+        case RendererResourceFormat_t::RGB565:
+            for (size_t i = 0; i < pixelCount; ++i, src += 2, dst += 4)
+            {
+                uint16_t pixel;
+                memcpy(&pixel, src, sizeof(pixel));
+                const uint32_t r = (pixel >> 11) & 0x1f;
+                const uint32_t g = (pixel >> 5) & 0x3f;
+                const uint32_t b = pixel & 0x1f;
+                dst[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+                dst[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+                dst[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+                dst[3] = 255;
+            }
+            break;
+
+        case RendererResourceFormat_t::RGBA16F:
+            for (size_t i = 0; i < pixelCount; ++i, src += 8, dst += 4)
+            {
+                uint16_t channels[4];
+                memcpy(channels, src, sizeof(channels));
+                for (int c = 0; c < 4; ++c)
+                    dst[c] = FloatToUnorm8(HalfToFloat(channels[c]));
+            }
+            break;
+
+        case RendererResourceFormat_t::NV12:
+            ConvertYUV420ToRGBA8(src, src + pixelCount, src + pixelCount + 1, 2, width, height, dst);
+            break;
+
+        case RendererResourceFormat_t::I420:
+        {
+            const size_t chromaSize = size_t((width + 1) / 2) * size_t((height + 1) / 2);
+            ConvertYUV420ToRGBA8(src, src + pixelCount, src + pixelCount + chromaSize, 1, width, height, dst);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return result;
+}
+
+}// namespace InGameOverlay
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <InGameOverlay/RendererResource.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace InGameOverlay {
+
+// A level of a mip chain, each one is half the size of the previous one.
+struct RendererTextureLevel_t
+{
+    const void* Data;
+    uint32_t Width;
+    uint32_t Height;
+};
+
+bool IsResourceFormatCompressed(RendererResourceFormat_t format);
+
+// The YUV 4:2:0 formats, their chroma planes are half the size of the Y plane, rounded up.
+bool IsResourceFormatPlanar(RendererResourceFormat_t format);
+
+// Bytes per pixel of the uncompressed and non planar formats.
+uint32_t GetResourceFormatPixelSize(RendererResourceFormat_t format);
+
+// Bytes of a width x height image, rounded up to whole blocks for the compressed formats.
+uint64_t GetResourceFormatSize(RendererResourceFormat_t format, uint32_t width, uint32_t height);
+
+// Expands the pixels to RGBA8, for the renderers that can't sample the format natively.
+// Returns an empty buffer for the compressed formats.
+std::vector<uint8_t> ConvertResourceFormatToRGBA8(RendererResourceFormat_t format, const void* pixels, uint32_t width, uint32_t height);
+
+}// namespace InGameOverlay
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mpmc_bounded_queue.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace InGameOverlay {
+
+// Multiple producers, single consumer queue.
+// Producers go through the lock-free ring, a mutex protected vector only takes the items when the ring is full.
+// Dequeue, Empty and Clear must only be called by the consumer.
+template<typename T>
+class ResourceQueue_t
+{
+    mpmc_bounded_queue<T> _Ring;
+    // While set, producers push to _Overflow so the items stay ordered.
+    std::atomic<bool> _Overflowing;
+    std::mutex _OverflowMutex;
+    std::vector<T> _Overflow;
+    // Consumer side, overflowed items being drained.
+    std::vector<T> _Draining;
+    size_t _DrainingIndex;
+
+public:
+    // ringSize must be a power of 2.
+    explicit ResourceQueue_t(size_t ringSize) :
+        _Ring(ringSize),
+        _Overflowing(false),
+        _DrainingIndex(0)
+    {}
+
+    void Enqueue(T const& value)
+    {
+        if (!_Overflowing.load(std::memory_order_acquire) && _Ring.enqueue(value))
+            return;
+
+        std::lock_guard<std::mutex> lock(_OverflowMutex);
+        _Overflow.emplace_back(value);
+        _Overflowing.store(true, std::memory_order_release);
+    }
+
+    bool Dequeue(T& value)
+    {
+        if (_Ring.dequeue(value))
+            return true;
+
+        if (_DrainingIndex >= _Draining.size())
+        {
+            if (!_Overflowing.load(std::memory_order_acquire))
+                return false;
+
+            std::lock_guard<std::mutex> lock(_OverflowMutex);
+            // Items still in the ring were pushed before the overflowed ones, or are still being written.
+            if (_Ring.queue_size() != 0)
+                return false;
+
+            _Draining.clear();
+            _DrainingIndex = 0;
+            std::swap(_Draining, _Overflow);
+            // Only go back to the ring once every overflowed item has been handed out.
+            if (_Draining.empty())
+            {
+                _Overflowing.store(false, std::memory_order_release);
+                return false;
+            }
+        }
+
+        value = std::move(_Draining[_DrainingIndex++]);
+        return true;
+    }
+
+    bool Empty()
+    {
+        if (_Ring.queue_size() != 0 || _DrainingIndex < _Draining.size())
+            return false;
+
+        if (!_Overflowing.load(std::memory_order_acquire))
+            return true;
+
+        std::lock_guard<std::mutex> lock(_OverflowMutex);
+        return _Overflow.empty();
+    }
+
+    void Clear()
+    {
+        T value;
+        while (Dequeue(value));
+    }
+};
+
+}// namespace InGameOverlay
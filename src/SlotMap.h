@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) Nemirtingas
+ * This file is part of the ingame overlay project
+ *
+ * The ingame overlay project is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * The ingame overlay project is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the ingame overlay project; if not, see
+ * <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+namespace InGameOverlay {
+
+struct SlotMapHandle_t
+{
+    uint32_t Index = 0;
+    // Odd while the slot is used, 0 is never handed out.
+    uint32_t Generation = 0;
+
+    inline bool IsValid() const { return Generation != 0; }
+
+    inline bool operator==(SlotMapHandle_t const& other) const { return Index == other.Index && Generation == other.Generation; }
+    inline bool operator!=(SlotMapHandle_t const& other) const { return !(*this == other); }
+};
+
+// Contiguous storage addressed by generational handles.
+// A handle goes stale as soon as its slot is removed, even if the slot gets reused.
+template<typename T>
+class SlotMap_t
+{
+    static constexpr uint32_t InvalidIndex = 0xffffffff;
+
+    struct Slot_t
+    {
+        T Value;
+        uint32_t Generation;
+        uint32_t NextFree;
+    };
+
+    std::vector<Slot_t> _Slots;
+    uint32_t _FreeHead;
+    size_t _Size;
+
+public:
+    SlotMap_t() :
+        _FreeHead(InvalidIndex),
+        _Size(0)
+    {}
+
+    SlotMapHandle_t Insert(T value)
+    {
+        uint32_t index;
+        if (_FreeHead != InvalidIndex)
+        {
+            index = _FreeHead;
+            _FreeHead = _Slots[index].NextFree;
+        }
+        else
+        {
+            index = static_cast<uint32_t>(_Slots.size());
+            _Slots.emplace_back(Slot_t{ T{}, 0, InvalidIndex });
+        }
+
+        auto& slot = _Slots[index];
+        slot.Value = std::move(value);
+        ++slot.Generation;
+        ++_Size;
+
+        return SlotMapHandle_t{ index, slot.Generation };
+    }
+
+    T* Get(SlotMapHandle_t handle)
+    {
+        if (handle.Index >= _Slots.size() || _Slots[handle.Index].Generation != handle.Generation || !(handle.Generation & 1))
+            return nullptr;
+
+        return &_Slots[handle.Index].Value;
+    }
+
+    T const* Get(SlotMapHandle_t handle) const
+    {
+        return const_cast<SlotMap_t*>(this)->Get(handle);
+    }
+
+    // Returns the removed value, or a default constructed one if the handle is stale.
+    T Remove(SlotMapHandle_t handle)
+    {
+        T* value = Get(handle);
+        if (value == nullptr)
+            return T{};
+
+        T result = std::move(*value);
+        *value = T{};
+
+        auto& slot = _Slots[handle.Index];
+        ++slot.Generation;
+        slot.NextFree = _FreeHead;
+        _FreeHead = handle.Index;
+        --_Size;
+
+        return result;
+    }
+
+    // Removes every value, all the handles handed out so far become stale.
+    void Clear()
+    {
+        _FreeHead = InvalidIndex;
+        for (uint32_t i = static_cast<uint32_t>(_Slots.size()); i-- > 0;)
+        {
+            auto& slot = _Slots[i];
+            if (slot.Generation & 1)
+            {
+                slot.Value = T{};
+                ++slot.Generation;
+            }
+            slot.NextFree = _FreeHead;
+            _FreeHead = i;
+        }
+        _Size = 0;
+    }
+
+    template<typename F>
+    void ForEach(F&& f)
+    {
+        for (auto& slot : _Slots)
+        {
+            if (slot.Generation & 1)
+                f(slot.Value);
+        }
+    }
+
+    template<typename F>
+    void ForEachWithHandle(F&& f)
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(_Slots.size()); ++i)
+        {
+            auto& slot = _Slots[i];
+            if (slot.Generation & 1)
+                f(SlotMapHandle_t{ i, slot.Generation }, slot.Value);
+        }
+    }
+
+    template<typename F>
+    size_t CountIf(F&& f)
+    {
+        size_t count = 0;
+        ForEach([&](T& value)
+        {
+            if (f(value))
+                ++count;
+        });
+        return count;
+    }
+
+    size_t Size() const { return _Size; }
+
+    bool Empty() const { return _Size == 0; }
+};
+
+}// namespace InGameOverlay
@@ -171,7 +171,7 @@ void DX10Hook_t::_UpdateHookDeviceRefCount() {
           + 1 // ImGui Font Shader View
 
           + _ImageResourcesToRelease.size() +
-          std::count_if(_ImageResources.begin(), _ImageResources.end(), [](std::shared_ptr<RendererTexture_t> tex) {
+          _ImageResources.CountIf([](std::shared_ptr<RendererTexture_t> const& tex) {
             return tex->LoadStatus == RendererTextureStatus_e::Loaded;
           });
       break;
@@ -221,8 +221,8 @@ void DX10Hook_t::_ResetRenderState(OverlayHookState state) {
       WindowsHook_t::Inst()->ResetRenderState(state);
       ImGui::DestroyContext();
 
-      _ImageResources.clear();
-      _ImageResourcesToLoad.clear();
+      _ClearImageResources();
+      _ClearImageResourcesToLoad();
       _ImageResourcesToRelease.clear();
       _DestroyRenderTargets();
       SafeRelease(_Device);
@@ -280,7 +280,7 @@ void DX10Hook_t::_PrepareForOverlay(IDXGISwapChain* pSwapChain, UINT flags) {
       ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
     }
 
-    ++_CurrentFrame;
+    _BeginFrame();
     ImGui::NewFrame();
 
     OverlayProc();
@@ -299,28 +299,26 @@ void DX10Hook_t::_PrepareForOverlay(IDXGISwapChain* pSwapChain, UINT flags) {
 }
 
 void DX10Hook_t::_LoadResources() {
-  if (_ImageResourcesToLoad.empty())
+  if (!_HasImageResourcesToLoad())
     return;
 
   struct ValidTexture_t {
-    std::shared_ptr<RendererTexture_t> Resource;
+    RendererTexture_t* Resource;
     const void* Data;
+    std::shared_ptr<const void> DataOwner;
     uint32_t Width;
     uint32_t Height;
   };
 
   std::vector<ValidTexture_t> validResources;
 
-  const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-  for (size_t i = 0; i < loadParameterCount; ++i) {
-    auto& param = _ImageResourcesToLoad[i];
-
-    auto r = param.Resource.lock();
-    if (!r)
+  RendererTextureLoadParameter_t param;
+  for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i) {
+    auto r = GetImageResource(param.Resource);
+    if (r == nullptr)
       continue;
 
-    validResources.push_back({r, param.Data, param.Width, param.Height});
+    validResources.push_back({r, param.Data, std::move(param.DataOwner), param.Width, param.Height});
   }
 
   if (validResources.empty())
@@ -361,15 +359,15 @@ void DX10Hook_t::_LoadResources() {
     pTexture->Release();
 
     tex.Resource->ImGuiTextureId = reinterpret_cast<uint64_t>(srv);
-    tex.Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+    _ImageResourceLoaded(tex.Resource);
   }
 
-  _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(), _ImageResourcesToLoad.begin() + loadParameterCount);
-
   _UpdateHookDeviceRefCount();
 }
 
 void DX10Hook_t::_ReleaseResources() {
+  _RemoveReleasedImageResources(_ImageResourcesToRelease);
+
   if (_ImageResourcesToRelease.empty())
     return;
 
@@ -548,7 +546,7 @@ void DX10Hook_t::LoadFunctions(decltype(_ID3D10DeviceRelease) releaseFcn, declty
   _IDXGISwapChain1Present1 = present1Fcn;
 }
 
-std::weak_ptr<RendererTexture_t> DX10Hook_t::AllocImageResource() {
+RendererTextureHandle_t DX10Hook_t::AllocImageResource() {
   auto ptr = std::shared_ptr<RendererTexture_t>(new RendererTexture_t(), [](RendererTexture_t* handle) {
     if (handle != nullptr) {
       auto* resource = reinterpret_cast<ID3D10ShaderResourceView*>(handle->ImGuiTextureId);
@@ -557,24 +555,7 @@ std::weak_ptr<RendererTexture_t> DX10Hook_t::AllocImageResource() {
     }
   });
 
-  _ImageResources.emplace(ptr);
-
-  return ptr;
-}
-
-void DX10Hook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter) {
-  _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void DX10Hook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) {
-  auto ptr = resource.lock();
-  if (ptr) {
-    auto it = _ImageResources.find(ptr);
-    if (it != _ImageResources.end()) {
-      _ImageResources.erase(it);
-      _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t{std::move(ptr), _CurrentFrame});
-    }
-  }
+  return _ImageResources.Insert(std::move(ptr));
 }
 
 } // namespace InGameOverlay
\ No newline at end of file
@@ -42,8 +42,6 @@ private:
     ULONG _HookDeviceRefCount;
     OverlayHookState _HookState;
     ID3D10RenderTargetView* _RenderTargetView;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
 
@@ -93,9 +91,7 @@ public:
         decltype(_IDXGISwapChainResizeTarget) resizeTargetFcn,
         decltype(_IDXGISwapChain1Present1) present1Fcn);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
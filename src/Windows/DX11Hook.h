@@ -43,8 +43,6 @@ private:
     OverlayHookState _HookState;
     ID3D11DeviceContext* _DeviceContext;
     ID3D11RenderTargetView* _RenderTargetView;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
 
@@ -94,9 +92,7 @@ public:
         decltype(_IDXGISwapChainResizeTarget) resizeTargetFcn,
         decltype(_IDXGISwapChain1Present1) rresent1Fcn);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }
\ No newline at end of file
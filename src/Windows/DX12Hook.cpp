@@ -265,10 +265,9 @@ void DX12Hook_t::_UpdateHookDeviceRefCount() {
           + 1                               // ImageCommandAllocator
           + 1                               // ImageCommandList
           + _ShaderResourceViewHeapDescriptors.size() + _ImageResourcesToRelease.size() +
-          std::count_if(_ImageResources.begin(), _ImageResources.end(),
-                        [](std::shared_ptr<RendererTexture_t> tex) {
-                          return tex->LoadStatus == RendererTextureStatus_e::Loaded;
-                        }) +
+          _ImageResources.CountIf([](std::shared_ptr<RendererTexture_t> const& tex) {
+            return tex->LoadStatus == RendererTextureStatus_e::Loaded;
+          }) +
           1                             // ImGui PipelineState
           + 1                           // ImGui FontTexture
           + (_OverlayFrames.size() * 2) // ImGui VertexBuffer + IndexBuffer
@@ -415,8 +414,8 @@ void DX12Hook_t::_ResetRenderState(OverlayHookState state) {
       WindowsHook_t::Inst()->ResetRenderState(state);
       ImGui::DestroyContext();
 
-      _ImageResources.clear();
-      _ImageResourcesToLoad.clear();
+      _ClearImageResources();
+      _ClearImageResourcesToLoad();
       _ImageResourcesToRelease.clear();
       _DestroyImageObjects();
       _ShaderResourceViewHeaps.clear();
@@ -538,7 +537,7 @@ void DX12Hook_t::_PrepareForOverlay(IDXGISwapChain* pSwapChain, ID3D12CommandQue
       ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
     }
 
-    ++_CurrentFrame;
+    _BeginFrame();
     ImGui::NewFrame();
 
     OverlayProc();
@@ -580,7 +579,7 @@ void DX12Hook_t::_PrepareForOverlay(IDXGISwapChain* pSwapChain, ID3D12CommandQue
 void DX12Hook_t::_LoadResources() {
   HRESULT hr;
 
-  if (_ImageResourcesToLoad.empty())
+  if (!_HasImageResourcesToLoad())
     return;
 
   D3D12_HEAP_PROPERTIES defaultProps{};
@@ -592,24 +591,23 @@ void DX12Hook_t::_LoadResources() {
   uploadProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
 
   struct ValidTexture_t {
-    std::shared_ptr<DX12Texture_t> Resource;
+    DX12Texture_t* Resource;
     const void* Data;
+    std::shared_ptr<const void> DataOwner;
     uint32_t Width;
     uint32_t Height;
   };
 
   std::vector<ValidTexture_t> validResources;
 
-  const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-  for (size_t i = 0; i < loadParameterCount; ++i) {
-    auto& param = _ImageResourcesToLoad[i];
-    auto r = param.Resource.lock();
-    if (!r)
+  RendererTextureLoadParameter_t param;
+  for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i) {
+    auto r = GetImageResource(param.Resource);
+    if (r == nullptr)
       continue;
 
     validResources.push_back(
-        ValidTexture_t{std::static_pointer_cast<DX12Texture_t>(r), param.Data, param.Width, param.Height});
+        ValidTexture_t{static_cast<DX12Texture_t*>(r), param.Data, std::move(param.DataOwner), param.Width, param.Height});
   }
 
   if (!validResources.empty()) {
@@ -735,18 +733,18 @@ void DX12Hook_t::_LoadResources() {
 
     for (size_t i = 0; i < validResources.size(); ++i) {
       validResources[i].Resource->pTexture = createdTextures[i];
-      validResources[i].Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+      _ImageResourceLoaded(validResources[i].Resource);
     }
 
     SafeRelease(uploadBuffer);
   }
 
-  _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(), _ImageResourcesToLoad.begin() + loadParameterCount);
-
   _UpdateHookDeviceRefCount();
 }
 
 void DX12Hook_t::_ReleaseResources() {
+  _RemoveReleasedImageResources(_ImageResourcesToRelease);
+
   if (_ImageResourcesToRelease.empty())
     return;
 
@@ -1075,11 +1073,11 @@ void DX12Hook_t::LoadFunctions(decltype(_ID3D12DeviceRelease) releaseFcn, declty
   _ID3D12CommandQueueExecuteCommandLists = executeCommandListsFcn;
 }
 
-std::weak_ptr<RendererTexture_t> DX12Hook_t::AllocImageResource() {
+RendererTextureHandle_t DX12Hook_t::AllocImageResource() {
   auto shaderRessourceView = _GetFreeShaderRessourceView();
 
   if (shaderRessourceView.Id == ShaderRessourceView_t::InvalidId)
-    return std::weak_ptr<RendererTexture_t>{};
+    return RendererTextureHandle_t{};
 
   DX12Texture_t* pTextureData = new DX12Texture_t;
   pTextureData->ImGuiTextureId = shaderRessourceView.GpuHandle.ptr;
@@ -1096,24 +1094,7 @@ std::weak_ptr<RendererTexture_t> DX12Hook_t::AllocImageResource() {
     }
   });
 
-  _ImageResources.emplace(image);
-
-  return image;
-}
-
-void DX12Hook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter) {
-  _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void DX12Hook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) {
-  auto ptr = resource.lock();
-  if (ptr) {
-    auto it = _ImageResources.find(ptr);
-    if (it != _ImageResources.end()) {
-      _ImageResources.erase(it);
-      _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t{std::move(ptr), _CurrentFrame});
-    }
-  }
+  return _ImageResources.Insert(std::move(image));
 }
 
 } // namespace InGameOverlay
\ No newline at end of file
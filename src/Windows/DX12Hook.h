@@ -145,8 +145,6 @@ private:
     ID3D12CommandQueue* _ImageCommandQueue;
     ID3D12CommandAllocator* _ImageCommandAllocator;
     ID3D12GraphicsCommandList* _ImageCommandList;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     uint32_t _ImGuiFontTextureId;
     void* _ImGuiFontAtlas;
@@ -211,9 +209,7 @@ public:
         decltype(_IDXGISwapChain3ResizeBuffers1) resizeBuffers1Fcn,
         decltype(_ID3D12CommandQueueExecuteCommandLists) xecuteCommandListsFcn);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
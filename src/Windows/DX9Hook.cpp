@@ -147,7 +147,7 @@ void DX9Hook_t::_UpdateHookDeviceRefCount() {
           + 1 // ImGui Index Buffer
           + 1 // ImGui Font Texture
           + _ImageResourcesToRelease.size() +
-          std::count_if(_ImageResources.begin(), _ImageResources.end(), [](std::shared_ptr<RendererTexture_t> tex) {
+          _ImageResources.CountIf([](std::shared_ptr<RendererTexture_t> const& tex) {
             return tex->LoadStatus == RendererTextureStatus_e::Loaded;
           });
   }
@@ -168,8 +168,8 @@ void DX9Hook_t::_ResetRenderState(OverlayHookState state) {
     case OverlayHookState::Reset:
       ImGui_ImplDX9_InvalidateDeviceObjects();
       // Yes, clearing images is required when resetting or DirectX9 will return a D3DERR_INVALIDCALL error
-      _ImageResources.clear();
-      _ImageResourcesToLoad.clear();
+      _ClearImageResources();
+      _ClearImageResourcesToLoad();
       _ImageResourcesToRelease.clear();
       break;
 
@@ -178,8 +178,8 @@ void DX9Hook_t::_ResetRenderState(OverlayHookState state) {
       WindowsHook_t::Inst()->ResetRenderState(state);
       ImGui::DestroyContext();
 
-      _ImageResources.clear();
-      _ImageResourcesToLoad.clear();
+      _ClearImageResources();
+      _ClearImageResourcesToLoad();
       _ImageResourcesToRelease.clear();
       SafeRelease(_Device);
 
@@ -249,7 +249,7 @@ void DX9Hook_t::_PrepareForOverlay(IDirect3DDevice9* pDevice, HWND destWindow) {
       ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
     }
 
-    ++_CurrentFrame;
+    _BeginFrame();
     ImGui::NewFrame();
 
     OverlayProc();
@@ -269,27 +269,26 @@ void DX9Hook_t::_PrepareForOverlay(IDirect3DDevice9* pDevice, HWND destWindow) {
 void DX9Hook_t::_LoadResources() {
   HRESULT hr;
 
-  if (_ImageResourcesToLoad.empty())
+  if (!_HasImageResourcesToLoad())
     return;
 
   struct ValidTexture_t {
-    std::shared_ptr<RendererTexture_t> Resource;
+    RendererTexture_t* Resource;
     const void* Data;
+    std::shared_ptr<const void> DataOwner;
     uint32_t Width;
     uint32_t Height;
   };
 
   std::vector<ValidTexture_t> validResources;
 
-  const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-  for (size_t i = 0; i < loadParameterCount; ++i) {
-    auto& param = _ImageResourcesToLoad[i];
-    auto r = param.Resource.lock();
-    if (!r)
+  RendererTextureLoadParameter_t param;
+  for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i) {
+    auto r = GetImageResource(param.Resource);
+    if (r == nullptr)
       continue;
 
-    validResources.push_back(ValidTexture_t{r, param.Data, param.Width, param.Height});
+    validResources.push_back(ValidTexture_t{r, param.Data, std::move(param.DataOwner), param.Width, param.Height});
   }
 
   if (!validResources.empty()) {
@@ -319,7 +318,7 @@ void DX9Hook_t::_LoadResources() {
 
           if (SUCCEEDED(dx9Tex->UnlockRect(0))) {
             tex.Resource->ImGuiTextureId = reinterpret_cast<uint64_t>(dx9Tex);
-            tex.Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+            _ImageResourceLoaded(tex.Resource);
             dx9Tex = nullptr;
           }
         }
@@ -329,12 +328,12 @@ void DX9Hook_t::_LoadResources() {
     }
   }
 
-  _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(), _ImageResourcesToLoad.begin() + loadParameterCount);
-
   _UpdateHookDeviceRefCount();
 }
 
 void DX9Hook_t::_ReleaseResources() {
+  _RemoveReleasedImageResources(_ImageResourcesToRelease);
+
   if (_ImageResourcesToRelease.empty())
     return;
 
@@ -542,7 +541,7 @@ void DX9Hook_t::LoadFunctions(decltype(_IDirect3DDevice9Release) ReleaseFcn,
   _IDirect3DSwapChain9SwapChainPresent = SwapChainPresentFcn;
 }
 
-std::weak_ptr<RendererTexture_t> DX9Hook_t::AllocImageResource() {
+RendererTextureHandle_t DX9Hook_t::AllocImageResource() {
   auto ptr = std::shared_ptr<RendererTexture_t>(new RendererTexture_t(), [](RendererTexture_t* handle) {
     if (handle != nullptr) {
       auto* resource = reinterpret_cast<IDirect3DTexture9*>(handle->ImGuiTextureId);
@@ -551,24 +550,7 @@ std::weak_ptr<RendererTexture_t> DX9Hook_t::AllocImageResource() {
     }
   });
 
-  _ImageResources.emplace(ptr);
-
-  return ptr;
-}
-
-void DX9Hook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter) {
-  _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void DX9Hook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) {
-  auto ptr = resource.lock();
-  if (ptr) {
-    auto it = _ImageResources.find(ptr);
-    if (it != _ImageResources.end()) {
-      _ImageResources.erase(it);
-      _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t{std::move(ptr), _CurrentFrame});
-    }
-  }
+  return _ImageResources.Insert(std::move(ptr));
 }
 
 } // namespace InGameOverlay
\ No newline at end of file
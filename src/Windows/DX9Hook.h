@@ -41,8 +41,6 @@ private:
     IDirect3DDevice9* _Device;
     ULONG _HookDeviceRefCount;
     OverlayHookState _HookState;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
 
@@ -93,9 +91,7 @@ public:
         decltype(_IDirect3DDevice9ExResetEx) ResetExFcn,
         decltype(_IDirect3DSwapChain9SwapChainPresent) SwapChainPresentFcn);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
@@ -93,11 +93,12 @@ void OpenGLHook_t::_ResetRenderState(OverlayHookState state) {
       break;
 
     case OverlayHookState::Removing:
+      _DestroyYUVProgram();
       ImGui_ImplOpenGL3_Shutdown();
       WindowsHook_t::Inst()->ResetRenderState(state);
       // ImGui::DestroyContext();
 
-      _ImageResources.clear();
+      _ClearImageResources();
 
       _LastWindow = nullptr;
       _Initialized = false;
@@ -135,7 +136,7 @@ void OpenGLHook_t::_PrepareForOverlay(HDC hDC) {
       ImFontAtlasUpdateNewFrame(reinterpret_cast<ImFontAtlas*>(_ImGuiFontAtlas), ImGui::GetFrameCount(), has_textures);
     }
 
-    ++_CurrentFrame;
+    _BeginFrame();
     ImGui::NewFrame();
 
     OverlayProc();
@@ -152,8 +153,264 @@ void OpenGLHook_t::_PrepareForOverlay(HDC hDC) {
   }
 }
 
+struct OpenGLTextureFormat_t {
+  GLint InternalFormat;
+  GLenum Format;
+  GLenum Type;
+  // Single channel formats are spread with the texture swizzle, the shader always samples RGBA.
+  GLint Swizzle[4];
+  // Uploaded with glCompressedTexImage2D, Format and Type are unused.
+  bool Compressed = false;
+};
+
+static OpenGLTextureFormat_t ResourceFormatToOpenGLFormat(RendererResourceFormat_t format) {
+  switch (format) {
+    case RendererResourceFormat_t::BGRA8:
+      return {GL_RGBA, GL_BGRA, GL_UNSIGNED_BYTE, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}};
+    case RendererResourceFormat_t::R8:
+      return {GL_R8, GL_RED, GL_UNSIGNED_BYTE, {GL_RED, GL_RED, GL_RED, GL_ONE}};
+    case RendererResourceFormat_t::A8:
+      return {GL_R8, GL_RED, GL_UNSIGNED_BYTE, {GL_ONE, GL_ONE, GL_ONE, GL_RED}};
+    case RendererResourceFormat_t::RG8:
+      return {GL_RG8, GL_RG, GL_UNSIGNED_BYTE, {GL_RED, GL_RED, GL_RED, GL_GREEN}};
+    case RendererResourceFormat_t::RGB565:
+      return {GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}};
+    case RendererResourceFormat_t::RGBA16F:
+      return {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}};
+    case RendererResourceFormat_t::BC1:
+      return {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, true};
+    case RendererResourceFormat_t::BC3:
+      return {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, true};
+    case RendererResourceFormat_t::BC4:
+      return {GL_COMPRESSED_RED_RGTC1, 0, 0, {GL_RED, GL_RED, GL_RED, GL_ONE}, true};
+    case RendererResourceFormat_t::BC5:
+      return {GL_COMPRESSED_RG_RGTC2, 0, 0, {GL_RED, GL_RED, GL_RED, GL_GREEN}, true};
+    case RendererResourceFormat_t::BC7:
+      return {GL_COMPRESSED_RGBA_BPTC_UNORM_ARB, 0, 0, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, true};
+    case RendererResourceFormat_t::ETC2RGB8:
+      return {GL_COMPRESSED_RGB8_ETC2, 0, 0, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, true};
+    case RendererResourceFormat_t::ETC2RGBA8:
+      return {GL_COMPRESSED_RGBA8_ETC2_EAC, 0, 0, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, true};
+    default:
+      return {GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}};
+  }
+}
+
+bool OpenGLHook_t::_SupportsResourceFormat(RendererResourceFormat_t format) {
+  switch (format) {
+    // Texture swizzle is core since OpenGL 3.3.
+    case RendererResourceFormat_t::R8:
+    case RendererResourceFormat_t::A8:
+    case RendererResourceFormat_t::RG8:
+    case RendererResourceFormat_t::BC4:
+    case RendererResourceFormat_t::BC5:
+    // The planes are sampled by a GLSL 330 program.
+    case RendererResourceFormat_t::NV12:
+    case RendererResourceFormat_t::I420:
+      return GLAD_GL_VERSION_3_3 != 0;
+
+    case RendererResourceFormat_t::BC1:
+    case RendererResourceFormat_t::BC3:
+      return GLAD_GL_EXT_texture_compression_s3tc != 0;
+
+    case RendererResourceFormat_t::BC7:
+      return GLAD_GL_ARB_texture_compression_bptc != 0;
+
+    case RendererResourceFormat_t::ETC2RGB8:
+    case RendererResourceFormat_t::ETC2RGBA8:
+      return GLAD_GL_ARB_ES3_compatibility != 0;
+
+    default:
+      return true;
+  }
+}
+
+bool OpenGLHook_t::_SupportsResourceMipLevels() {
+  return true;
+}
+
+static GLuint CompileYUVShader(GLenum type, const char* source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+
+  GLint status = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status != GL_TRUE) {
+    glDeleteShader(shader);
+    return 0;
+  }
+
+  return shader;
+}
+
+bool OpenGLHook_t::_CreateYUVProgram() {
+  if (_YUVProgram != 0)
+    return true;
+
+  if (_YUVProgramFailed)
+    return false;
+
+  // A single triangle covering the viewport.
+  static constexpr char vertexShaderSource[] =
+      "#version 330\n"
+      "out vec2 Frag_UV;\n"
+      "void main() {\n"
+      "  Frag_UV = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));\n"
+      "  gl_Position = vec4(Frag_UV * 2.0 - 1.0, 0.0, 1.0);\n"
+      "}\n";
+
+  // BT.601 limited range.
+  static constexpr char fragmentShaderSource[] =
+      "#version 330\n"
+      "uniform sampler2D PlaneY;\n"
+      "uniform sampler2D PlaneU;\n"
+      "uniform sampler2D PlaneV;\n"
+      "uniform bool Interleaved;\n"
+      "in vec2 Frag_UV;\n"
+      "out vec4 Out_Color;\n"
+      "void main() {\n"
+      "  vec2 chroma = Interleaved ? texture(PlaneU, Frag_UV).rg\n"
+      "                            : vec2(texture(PlaneU, Frag_UV).r, texture(PlaneV, Frag_UV).r);\n"
+      "  vec3 yuv = vec3(texture(PlaneY, Frag_UV).r - 16.0 / 255.0, chroma - 128.0 / 255.0);\n"
+      "  mat3 toRGB = mat3(1.164383, 1.164383, 1.164383, 0.0, -0.391762, 2.017232, 1.596027, -0.812968, 0.0);\n"
+      "  Out_Color = vec4(clamp(toRGB * yuv, 0.0, 1.0), 1.0);\n"
+      "}\n";
+
+  GLuint vertexShader = CompileYUVShader(GL_VERTEX_SHADER, vertexShaderSource);
+  GLuint fragmentShader = CompileYUVShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+  GLint status = GL_FALSE;
+  if (vertexShader != 0 && fragmentShader != 0) {
+    _YUVProgram = glCreateProgram();
+    glAttachShader(_YUVProgram, vertexShader);
+    glAttachShader(_YUVProgram, fragmentShader);
+    glLinkProgram(_YUVProgram);
+    glGetProgramiv(_YUVProgram, GL_LINK_STATUS, &status);
+  }
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+
+  if (status != GL_TRUE) {
+    INGAMEOVERLAY_ERROR("Failed to build the YUV conversion program, converting on the CPU.");
+    _DestroyYUVProgram();
+    _YUVProgramFailed = true;
+    return false;
+  }
+
+  GLint oldProgram;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &oldProgram);
+  glUseProgram(_YUVProgram);
+  glUniform1i(glGetUniformLocation(_YUVProgram, "PlaneY"), 0);
+  glUniform1i(glGetUniformLocation(_YUVProgram, "PlaneU"), 1);
+  glUniform1i(glGetUniformLocation(_YUVProgram, "PlaneV"), 2);
+  glUseProgram(static_cast<GLuint>(oldProgram));
+  _YUVInterleavedLocation = glGetUniformLocation(_YUVProgram, "Interleaved");
+
+  return true;
+}
+
+void OpenGLHook_t::_DestroyYUVProgram() {
+  if (_YUVProgram != 0)
+    glDeleteProgram(_YUVProgram);
+
+  _YUVProgram = 0;
+  _YUVInterleavedLocation = -1;
+  _YUVProgramFailed = false;
+}
+
+// Renders the planes into the already allocated RGBA texture, the caller's GL state is left untouched.
+bool OpenGLHook_t::_ConvertYUVTexture(uint32_t texture, const void* data, uint32_t width, uint32_t height,
+                                      RendererResourceFormat_t format) {
+  if (!_CreateYUVProgram())
+    return false;
+
+  const bool interleaved = format == RendererResourceFormat_t::NV12;
+  const uint32_t chromaWidth = (width + 1) / 2;
+  const uint32_t chromaHeight = (height + 1) / 2;
+  auto planeY = static_cast<const uint8_t*>(data);
+  auto planeU = planeY + size_t(width) * height;
+  auto planeV = planeU + size_t(chromaWidth) * chromaHeight;
+
+  GLint oldProgram, oldVertexArray, oldFramebuffer, oldActiveTexture, oldViewport[4];
+  GLint oldTextures[3], oldSamplers[3];
+  GLboolean oldColorMask[4];
+  glGetIntegerv(GL_CURRENT_PROGRAM, &oldProgram);
+  glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &oldVertexArray);
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &oldFramebuffer);
+  glGetIntegerv(GL_ACTIVE_TEXTURE, &oldActiveTexture);
+  glGetIntegerv(GL_VIEWPORT, oldViewport);
+  glGetBooleanv(GL_COLOR_WRITEMASK, oldColorMask);
+  const GLenum capabilities[] = {GL_BLEND, GL_SCISSOR_TEST, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_CULL_FACE};
+  GLboolean oldCapabilities[sizeof(capabilities) / sizeof(capabilities[0])];
+  for (size_t i = 0; i < sizeof(capabilities) / sizeof(capabilities[0]); ++i) {
+    oldCapabilities[i] = glIsEnabled(capabilities[i]);
+    glDisable(capabilities[i]);
+  }
+
+  GLuint planes[3] = {};
+  const GLsizei planeCount = interleaved ? 2 : 3;
+  glGenTextures(planeCount, planes);
+  for (GLsizei i = 0; i < planeCount; ++i) {
+    glActiveTexture(GL_TEXTURE0 + i);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTextures[i]);
+    glGetIntegerv(GL_SAMPLER_BINDING, &oldSamplers[i]);
+    glBindSampler(i, 0);
+    glBindTexture(GL_TEXTURE_2D, planes[i]);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    if (i == 0)
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, planeY);
+    else if (interleaved)
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, chromaWidth, chromaHeight, 0, GL_RG, GL_UNSIGNED_BYTE, planeU);
+    else
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, chromaWidth, chromaHeight, 0, GL_RED, GL_UNSIGNED_BYTE,
+                   i == 1 ? planeU : planeV);
+  }
+
+  // Framebuffers and vertex arrays are not shared between contexts, keep them for this conversion only.
+  GLuint framebuffer = 0, vertexArray = 0;
+  glGenFramebuffers(1, &framebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+  glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+  const bool complete = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  if (complete) {
+    glGenVertexArrays(1, &vertexArray);
+    glBindVertexArray(vertexArray);
+    glUseProgram(_YUVProgram);
+    glUniform1i(_YUVInterleavedLocation, interleaved ? 1 : 0);
+    glViewport(0, 0, width, height);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+  }
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(oldFramebuffer));
+  glDeleteFramebuffers(1, &framebuffer);
+  glBindVertexArray(static_cast<GLuint>(oldVertexArray));
+  if (vertexArray != 0)
+    glDeleteVertexArrays(1, &vertexArray);
+  glUseProgram(static_cast<GLuint>(oldProgram));
+  glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+  glColorMask(oldColorMask[0], oldColorMask[1], oldColorMask[2], oldColorMask[3]);
+  for (size_t i = 0; i < sizeof(capabilities) / sizeof(capabilities[0]); ++i) {
+    if (oldCapabilities[i])
+      glEnable(capabilities[i]);
+  }
+  for (GLsizei i = planeCount; i-- > 0;) {
+    glActiveTexture(GL_TEXTURE0 + i);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(oldTextures[i]));
+    glBindSampler(i, static_cast<GLuint>(oldSamplers[i]));
+  }
+  glActiveTexture(static_cast<GLenum>(oldActiveTexture));
+  glDeleteTextures(planeCount, planes);
+
+  return complete;
+}
+
 void OpenGLHook_t::_LoadResources() {
-  if (_ImageResourcesToLoad.empty())
+  if (!_HasImageResourcesToLoad())
     return;
 
   // Save old texture id
@@ -161,48 +418,90 @@ void OpenGLHook_t::_LoadResources() {
   glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTex);
 
   struct ValidTexture_t {
-    std::shared_ptr<RendererTexture_t> Resource;
+    RendererTexture_t* Resource;
     const void* Data;
+    std::shared_ptr<const void> DataOwner;
     uint32_t Width;
     uint32_t Height;
+    RendererResourceFormat_t Format;
+    std::vector<RendererTextureLevel_t> MipLevels;
   };
 
   std::vector<ValidTexture_t> validResources;
 
-  const auto loadParameterCount = _ImageResourcesToLoad.size() > _BatchSize ? _BatchSize : _ImageResourcesToLoad.size();
-
-  for (size_t i = 0; i < loadParameterCount; ++i) {
-    auto& param = _ImageResourcesToLoad[i];
-    auto r = param.Resource.lock();
-    if (!r)
+  RendererTextureLoadParameter_t param;
+  for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i) {
+    auto r = GetImageResource(param.Resource);
+    if (r == nullptr)
       continue;
 
-    validResources.push_back(ValidTexture_t{r, param.Data, param.Width, param.Height});
+    validResources.push_back(
+        ValidTexture_t{r, param.Data, std::move(param.DataOwner), param.Width, param.Height, param.Format, std::move(param.MipLevels)});
   }
 
   if (!validResources.empty()) {
+    // Rows of 1 and 2 bytes pixels are not 4 bytes aligned.
+    GLint oldUnpackAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldUnpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     for (size_t i = 0; i < validResources.size(); ++i) {
       auto& tex = validResources[i];
 
       glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(tex.Resource->ImGuiTextureId));
 
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, tex.MipLevels.empty() ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-      // Upload pixels into texture
+      // The texture is complete with the levels it is given.
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(tex.MipLevels.size()));
+
+      if (IsResourceFormatPlanar(tex.Format)) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, tex.Width, tex.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        if (!_ConvertYUVTexture(static_cast<GLuint>(tex.Resource->ImGuiTextureId), tex.Data, tex.Width, tex.Height,
+                                tex.Format)) {
+          // The conversion program or the framebuffer is not available.
+          auto pixels = ConvertResourceFormatToRGBA8(tex.Format, tex.Data, tex.Width, tex.Height);
+          glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(tex.Resource->ImGuiTextureId));
+          glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, tex.Width, tex.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        }
+
+        _ImageResourceLoaded(tex.Resource);
+        continue;
+      }
+
+      const auto format = ResourceFormatToOpenGLFormat(tex.Format);
+      if (tex.Format == RendererResourceFormat_t::R8 || tex.Format == RendererResourceFormat_t::A8 ||
+          tex.Format == RendererResourceFormat_t::RG8 || tex.Format == RendererResourceFormat_t::BC4 ||
+          tex.Format == RendererResourceFormat_t::BC5)
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, format.Swizzle);
+
+      // Upload pixels into texture, the full size level first
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tex.Width, tex.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, tex.Data);
-
-      tex.Resource->LoadStatus = RendererTextureStatus_e::Loaded;
+      for (size_t level = 0; level <= tex.MipLevels.size(); ++level) {
+        const RendererTextureLevel_t pixels =
+            level == 0 ? RendererTextureLevel_t{tex.Data, tex.Width, tex.Height} : tex.MipLevels[level - 1];
+        if (format.Compressed)
+          glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), format.InternalFormat, pixels.Width,
+                                 pixels.Height, 0,
+                                 static_cast<GLsizei>(GetResourceFormatSize(tex.Format, pixels.Width, pixels.Height)),
+                                 pixels.Data);
+        else
+          glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), format.InternalFormat, pixels.Width, pixels.Height,
+                       0, format.Format, format.Type, pixels.Data);
+      }
+
+      _ImageResourceLoaded(tex.Resource);
     }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, oldUnpackAlignment);
   }
 
   glBindTexture(GL_TEXTURE_2D, oldTex);
-
-  _ImageResourcesToLoad.erase(_ImageResourcesToLoad.begin(), _ImageResourcesToLoad.begin() + loadParameterCount);
 }
 
 void OpenGLHook_t::_ReleaseResources() {
+  _RemoveReleasedImageResources(_ImageResourcesToRelease);
   _ImageResourcesToRelease.clear();
 }
 
@@ -252,7 +551,8 @@ BOOL WINAPI OpenGLHook_t::_MyWGLSwapBuffers(HDC hDC) {
 
 OpenGLHook_t::OpenGLHook_t()
     : _Hooked(false), _WindowsHooked(false), _Initialized(false), _HookState(OverlayHookState::Removing),
-      _LastWindow(nullptr), _ImGuiFontAtlas(nullptr), _WGLSwapBuffers(nullptr) {}
+      _LastWindow(nullptr), _ImGuiFontAtlas(nullptr), _YUVProgram(0),
+      _YUVInterleavedLocation(-1), _YUVProgramFailed(false), _WGLSwapBuffers(nullptr) {}
 
 OpenGLHook_t::~OpenGLHook_t() {
   INGAMEOVERLAY_INFO("OpenGL Hook removed");
@@ -285,11 +585,11 @@ void OpenGLHook_t::LoadFunctions(WGLSwapBuffers_t pfnwglSwapBuffers) {
   _WGLSwapBuffers = pfnwglSwapBuffers;
 }
 
-std::weak_ptr<RendererTexture_t> OpenGLHook_t::AllocImageResource() {
+RendererTextureHandle_t OpenGLHook_t::AllocImageResource() {
   GLuint texture = 0;
   glGenTextures(1, &texture);
   if (glGetError() != GL_NO_ERROR)
-    return std::weak_ptr<RendererTexture_t>{};
+    return RendererTextureHandle_t{};
 
   auto ptr = std::shared_ptr<RendererTexture_t>(new RendererTexture_t(), [](RendererTexture_t* handle) {
     if (handle != nullptr) {
@@ -300,24 +600,7 @@ std::weak_ptr<RendererTexture_t> OpenGLHook_t::AllocImageResource() {
   });
   ptr->ImGuiTextureId = static_cast<uint64_t>(texture);
 
-  _ImageResources.emplace(ptr);
-
-  return ptr;
-}
-
-void OpenGLHook_t::LoadImageResource(RendererTextureLoadParameter_t& loadParameter) {
-  _ImageResourcesToLoad.emplace_back(loadParameter);
-}
-
-void OpenGLHook_t::ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource) {
-  auto ptr = resource.lock();
-  if (ptr) {
-    auto it = _ImageResources.find(ptr);
-    if (it != _ImageResources.end()) {
-      _ImageResources.erase(it);
-      _ImageResourcesToRelease.emplace_back(RendererTextureReleaseParameter_t{std::move(ptr), _CurrentFrame});
-    }
-  }
+  return _ImageResources.Insert(std::move(ptr));
 }
 
 } // namespace InGameOverlay
\ No newline at end of file
@@ -41,10 +41,12 @@ private:
     bool _Initialized;
     OverlayHookState _HookState;
     HWND _LastWindow;
-    std::set<std::shared_ptr<RendererTexture_t>> _ImageResources;
-    std::vector<RendererTextureLoadParameter_t> _ImageResourcesToLoad;
     std::vector<RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
     void* _ImGuiFontAtlas;
+    // Converts the planar YUV resources to RGBA on the GPU, 0 until the first one is loaded.
+    uint32_t _YUVProgram;
+    int32_t _YUVInterleavedLocation;
+    bool _YUVProgramFailed;
 
     // Functions
     OpenGLHook_t();
@@ -52,6 +54,11 @@ private:
     void _ResetRenderState(OverlayHookState state);
     void _PrepareForOverlay(HDC hDC);
     void _LoadResources();
+    virtual bool _SupportsResourceFormat(RendererResourceFormat_t format);
+    virtual bool _SupportsResourceMipLevels();
+    bool _CreateYUVProgram();
+    void _DestroyYUVProgram();
+    bool _ConvertYUVTexture(uint32_t texture, const void* data, uint32_t width, uint32_t height, RendererResourceFormat_t format);
     void _ReleaseResources();
     void _HandleScreenshot();
 
@@ -74,9 +81,7 @@ public:
     virtual RendererHookType_t GetRendererHookType() const;
     void LoadFunctions(WGLSwapBuffers_t pfnwglSwapBuffers);
 
-    virtual std::weak_ptr<RendererTexture_t> AllocImageResource();
-    virtual void LoadImageResource(RendererTextureLoadParameter_t& loadParameter);
-    virtual void ReleaseImageResource(std::weak_ptr<RendererTexture_t> resource);
+    virtual RendererTextureHandle_t AllocImageResource();
 };
 
 }// namespace InGameOverlay
\ No newline at end of file
@@ -21,6 +21,9 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
 template<typename T>
 class mpmc_bounded_queue
@@ -89,7 +92,8 @@ public:
             else
                 pos = dequeue_pos_.load(std::memory_order_relaxed);
         }
-        data = cell->data_;
+        // Moved out so the cell doesn't keep the item alive until it gets overwritten.
+        data = std::move(cell->data_);
         item_count_.fetch_sub(1, std::memory_order_relaxed);
         cell->sequence_.store(pos + buffer_mask_ + 1, std::memory_order_release);
         return true;
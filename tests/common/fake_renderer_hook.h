@@ -0,0 +1,106 @@
+// Renderer without a device for the resource tests and benchmarks. Its textures are plain memory,
+// and a frame runs the load scheduler and the releases the same way the real renderers do.
+
+#pragma once
+
+#include "RendererHookInternal.h"
+#include "ResourceFormat.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+class FakeRendererHook_t : public InGameOverlay::RendererHookInternal_t
+{
+public:
+    struct FakeTexture_t : InGameOverlay::RendererTexture_t
+    {
+        std::vector<uint8_t> Pixels;
+    };
+
+private:
+    std::vector<InGameOverlay::RendererTextureReleaseParameter_t> _ImageResourcesToRelease;
+    uint64_t _NextTextureId = 0;
+
+    void _LoadResources()
+    {
+        if (!_HasImageResourcesToLoad())
+            return;
+
+        InGameOverlay::RendererTextureLoadParameter_t param;
+        for (uint32_t i = 0; i < _BatchSize && _NextImageResourceToLoad(param); ++i)
+        {
+            auto r = static_cast<FakeTexture_t*>(GetImageResource(param.Resource));
+            if (r == nullptr)
+                continue;
+
+            // Reads every byte like an upload does, freed pixels are noticed.
+            auto bytes = static_cast<const uint8_t*>(param.Data);
+            r->Pixels.assign(bytes, bytes + InGameOverlay::GetResourceFormatSize(param.Format, param.Width, param.Height));
+            ++Uploads;
+            _ImageResourceLoaded(r);
+        }
+    }
+
+    void _ReleaseResources()
+    {
+        _RemoveReleasedImageResources(_ImageResourcesToRelease);
+        _ImageResourcesToRelease.clear();
+    }
+
+public:
+    uint32_t Uploads = 0;
+
+    // Runs OverlayProc, then uploads and releases the textures like a present.
+    void RunFrame()
+    {
+        _BeginFrame();
+
+        if (OverlayProc)
+            OverlayProc();
+
+        _LoadResources();
+        _ReleaseResources();
+    }
+
+    FakeTexture_t const* FindTexture(uint64_t imguiTextureId)
+    {
+        FakeTexture_t const* result = nullptr;
+        _ImageResources.ForEachWithHandle([&](InGameOverlay::RendererTextureHandle_t, std::shared_ptr<InGameOverlay::RendererTexture_t>& texture)
+        {
+            if (texture->ImGuiTextureId == imguiTextureId)
+                result = static_cast<FakeTexture_t const*>(texture.get());
+        });
+        return result;
+    }
+
+    virtual bool StartHook(std::function<void()>, InGameOverlay::ToggleKey[], int, void*) { return false; }
+    virtual void HideAppInputs(bool) {}
+    virtual void HideOverlayInputs(bool) {}
+    virtual bool IsStarted() { return true; }
+    virtual const char* GetLibraryName() const { return "Fake"; }
+    virtual InGameOverlay::RendererHookType_t GetRendererHookType() const { return InGameOverlay::RendererHookType_t::Any; }
+
+    virtual InGameOverlay::RendererTextureHandle_t AllocImageResource()
+    {
+        auto texture = std::make_shared<FakeTexture_t>();
+        texture->ImGuiTextureId = ++_NextTextureId;
+        return _ImageResources.Insert(std::move(texture));
+    }
+};
+
+// Polls a condition set by the library worker threads, like the content hash or a decode.
+template<typename F>
+static bool WaitFor(F&& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+{
+    auto end = std::chrono::steady_clock::now() + timeout;
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > end)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
@@ -0,0 +1,478 @@
+// Records X11 input events and replays them through the hooked XPending, to measure the overlay events filtering.
+//   record <file> [events]       Records the key, button, motion and focus events of a new window, run it under Xvfb
+//                                and drive it with xdotool or a VNC client.
+//   synthesize <file> [events]   Writes a stream of fast mouse motions mixed with wheel, button and key events.
+//   replay <file> [repeat]       Replays the stream with the overlay hidden, then visible, and reports the events per
+//                                second, the per event latency percentiles and the allocations per event.
+// Replaying still needs an X server for the hooked connection:
+//   Xvfb :99 -screen 0 1280x720x24 &
+//   DISPLAY=:99 ./linux_x11_event_replay replay events.bin
+
+// The overlay headers must come first, Xlib defines macros like None and Status.
+#include "Linux/X11Hook.h"
+
+#undef Status
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<uint64_t> AllocationCount(0);
+
+void* operator new(size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+static constexpr char TraceMagic[8] = { 'I', 'G', 'O', 'X', '1', '1', 'E', 'V' };
+static constexpr uint32_t TraceVersion = 1;
+
+#pragma pack(push, 1)
+struct TraceHeader_t
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t EventCount;
+};
+
+// 16 bytes per event, the window and display are rebound when replaying.
+struct TraceEvent_t
+{
+    // Milliseconds since the previous event.
+    uint32_t TimeDelta;
+    uint8_t Type;
+    // Keycode, button, or focus detail.
+    uint8_t Detail;
+    // Modifiers and buttons state, or focus mode.
+    uint16_t State;
+    int16_t X;
+    int16_t Y;
+    int16_t RootX;
+    int16_t RootY;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TraceEvent_t) == 16, "The trace events must stay 16 bytes.");
+
+static bool WriteTrace(const char* path, std::vector<TraceEvent_t> const& events)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    TraceHeader_t header;
+    memcpy(header.Magic, TraceMagic, sizeof(header.Magic));
+    header.Version = TraceVersion;
+    header.EventCount = (uint32_t)events.size();
+
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        (events.empty() || fwrite(events.data(), sizeof(TraceEvent_t), events.size(), file) == events.size());
+    fclose(file);
+
+    return success;
+}
+
+static bool ReadTrace(const char* path, std::vector<TraceEvent_t>& events)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+
+    TraceHeader_t header;
+    bool success = fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.Magic, TraceMagic, sizeof(TraceMagic)) == 0 &&
+        header.Version == TraceVersion;
+
+    if (success)
+    {
+        events.resize(header.EventCount);
+        success = events.empty() || fread(events.data(), sizeof(TraceEvent_t), events.size(), file) == events.size();
+    }
+    fclose(file);
+
+    return success;
+}
+
+static bool ToTraceEvent(XEvent const& event, Time& lastTime, TraceEvent_t& traceEvent)
+{
+    Time time = lastTime;
+    switch (event.type)
+    {
+        case KeyPress: case KeyRelease:
+            traceEvent = TraceEvent_t{ 0, (uint8_t)event.type, (uint8_t)event.xkey.keycode, (uint16_t)event.xkey.state,
+                (int16_t)event.xkey.x, (int16_t)event.xkey.y, (int16_t)event.xkey.x_root, (int16_t)event.xkey.y_root };
+            time = event.xkey.time;
+            break;
+
+        case ButtonPress: case ButtonRelease:
+            traceEvent = TraceEvent_t{ 0, (uint8_t)event.type, (uint8_t)event.xbutton.button, (uint16_t)event.xbutton.state,
+                (int16_t)event.xbutton.x, (int16_t)event.xbutton.y, (int16_t)event.xbutton.x_root, (int16_t)event.xbutton.y_root };
+            time = event.xbutton.time;
+            break;
+
+        case MotionNotify:
+            traceEvent = TraceEvent_t{ 0, (uint8_t)event.type, 0, (uint16_t)event.xmotion.state,
+                (int16_t)event.xmotion.x, (int16_t)event.xmotion.y, (int16_t)event.xmotion.x_root, (int16_t)event.xmotion.y_root };
+            time = event.xmotion.time;
+            break;
+
+        case FocusIn: case FocusOut:
+            traceEvent = TraceEvent_t{ 0, (uint8_t)event.type, (uint8_t)event.xfocus.detail, (uint16_t)event.xfocus.mode, 0, 0, 0, 0 };
+            break;
+
+        default:
+            return false;
+    }
+
+    traceEvent.TimeDelta = lastTime == 0 ? 0 : (uint32_t)(time - lastTime);
+    lastTime = time;
+    return true;
+}
+
+static XEvent FromTraceEvent(TraceEvent_t const& traceEvent, Display* display, Window window, Time time)
+{
+    XEvent event{};
+    event.type = traceEvent.Type;
+    event.xany.display = display;
+    event.xany.window = window;
+
+    switch (traceEvent.Type)
+    {
+        case FocusIn: case FocusOut:
+            event.xfocus.detail = traceEvent.Detail;
+            event.xfocus.mode = traceEvent.State;
+            break;
+
+        default:
+            // Key, button and motion events share the same layout up to the state field.
+            event.xkey.root = DefaultRootWindow(display);
+            event.xkey.time = time;
+            event.xkey.x = traceEvent.X;
+            event.xkey.y = traceEvent.Y;
+            event.xkey.x_root = traceEvent.RootX;
+            event.xkey.y_root = traceEvent.RootY;
+            event.xkey.state = traceEvent.State;
+            event.xkey.same_screen = True;
+            if (traceEvent.Type == KeyPress || traceEvent.Type == KeyRelease)
+                event.xkey.keycode = traceEvent.Detail;
+            else if (traceEvent.Type == ButtonPress || traceEvent.Type == ButtonRelease)
+                event.xbutton.button = traceEvent.Detail;
+    }
+
+    return event;
+}
+
+static Window CreateWindow(Display* display, long eventMask)
+{
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1280, 720, 0, 0, 0);
+    XSelectInput(display, window, eventMask | StructureNotifyMask);
+    XMapWindow(display, window);
+
+    XEvent event;
+    do
+    {
+        XNextEvent(display, &event);
+    } while (event.type != MapNotify);
+
+    return window;
+}
+
+static int Record(const char* path, uint32_t maxEvents)
+{
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        printf("Failed to open X display.\n");
+        return 1;
+    }
+
+    Window window = CreateWindow(display, KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask | PointerMotionMask | FocusChangeMask);
+    XSetInputFocus(display, window, RevertToParent, CurrentTime);
+    printf("Recording %u events from window 0x%lx\n", maxEvents, window);
+
+    std::vector<TraceEvent_t> events;
+    Time lastTime = 0;
+    XEvent event;
+    TraceEvent_t traceEvent;
+    while (events.size() < maxEvents)
+    {
+        XNextEvent(display, &event);
+        if (event.type == DestroyNotify)
+            break;
+
+        if (ToTraceEvent(event, lastTime, traceEvent))
+            events.emplace_back(traceEvent);
+    }
+
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+
+    if (!WriteTrace(path, events))
+    {
+        printf("Failed to write %s\n", path);
+        return 1;
+    }
+
+    printf("Recorded %zu events to %s\n", events.size(), path);
+    return 0;
+}
+
+static int Synthesize(const char* path, uint32_t eventCount)
+{
+    std::vector<TraceEvent_t> events;
+    events.reserve(eventCount);
+
+    int16_t x = 640, y = 360;
+    uint32_t i = 0;
+    while (events.size() < eventCount)
+    {
+        // High rate mice: long motion runs at 1 ms intervals, with a click, a wheel burst or a key now and then.
+        switch (i++ % 64)
+        {
+            case 20:
+                events.emplace_back(TraceEvent_t{ 1, ButtonPress, Button1, 0, x, y, x, y });
+                events.emplace_back(TraceEvent_t{ 30, ButtonRelease, Button1, Button1Mask, x, y, x, y });
+                break;
+
+            case 40:
+                for (int wheel = 0; wheel < 8; ++wheel)
+                {
+                    events.emplace_back(TraceEvent_t{ 1, ButtonPress, Button5, 0, x, y, x, y });
+                    events.emplace_back(TraceEvent_t{ 0, ButtonRelease, Button5, 0, x, y, x, y });
+                }
+                break;
+
+            case 60:
+                // Keycode 38 is 'a' on the usual evdev keymap.
+                events.emplace_back(TraceEvent_t{ 1, KeyPress, 38, 0, x, y, x, y });
+                events.emplace_back(TraceEvent_t{ 50, KeyRelease, 38, 0, x, y, x, y });
+                break;
+
+            default:
+                x = (int16_t)(x + (i % 7) - 3);
+                y = (int16_t)(y + (i % 5) - 2);
+                events.emplace_back(TraceEvent_t{ 1, MotionNotify, 0, 0, x, y, x, y });
+        }
+    }
+    events.resize(eventCount);
+
+    if (!WriteTrace(path, events))
+    {
+        printf("Failed to write %s\n", path);
+        return 1;
+    }
+
+    printf("Wrote %zu events to %s\n", events.size(), path);
+    return 0;
+}
+
+// The hook learns the game display from the hooked XPending, it needs at least one event to look at.
+static void ReportGameDisplay(Display* display, Window window)
+{
+    XEvent event{};
+    event.type = ClientMessage;
+    event.xclient.window = window;
+    event.xclient.format = 32;
+    XPutBackEvent(display, &event);
+
+    while (XPending(display))
+        XNextEvent(display, &event);
+}
+
+struct ReplayResult_t
+{
+    uint64_t Events;
+    double Seconds;
+    uint64_t Allocations;
+    // Nanoseconds per event of each XPending call, weighted by the events it consumed.
+    std::vector<double> EventLatencies;
+};
+
+static ReplayResult_t ReplayTrace(Display* display, Window window, std::vector<TraceEvent_t> const& events, int repeat)
+{
+    // XPutBackEvent pushes at the head of the queue, the events are pushed in reverse order in batches.
+    static constexpr size_t BatchSize = 256;
+
+    ReplayResult_t result{};
+    std::vector<XEvent> batch;
+    Time time = CurrentTime;
+
+    for (int pass = 0; pass < repeat; ++pass)
+    {
+        for (size_t begin = 0; begin < events.size(); begin += BatchSize)
+        {
+            const size_t end = std::min(events.size(), begin + BatchSize);
+            batch.clear();
+            for (size_t i = begin; i < end; ++i)
+            {
+                time += events[i].TimeDelta;
+                batch.emplace_back(FromTraceEvent(events[i], display, window, time));
+            }
+
+            for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+                XPutBackEvent(display, &*it);
+
+            XEvent event;
+            const uint64_t allocations = AllocationCount.load(std::memory_order_relaxed);
+            auto batchStart = Clock::now();
+            for (;;)
+            {
+                const int queued = XQLength(display);
+                auto start = Clock::now();
+                const int pending = XPending(display);
+                if (pending > 0)
+                    XNextEvent(display, &event);
+                auto end = Clock::now();
+
+                const int consumed = queued - XQLength(display);
+                if (consumed > 0)
+                {
+                    const double latency = std::chrono::duration<double, std::nano>(end - start).count() / consumed;
+                    result.EventLatencies.insert(result.EventLatencies.end(), consumed, latency);
+                }
+
+                if (pending <= 0)
+                    break;
+            }
+            result.Seconds += std::chrono::duration<double>(Clock::now() - batchStart).count();
+            result.Allocations += AllocationCount.load(std::memory_order_relaxed) - allocations;
+            result.Events += batch.size();
+
+            // ImGui::NewFrame is never called, drop the events the overlay received.
+            ImGui::GetCurrentContext()->InputEventsQueue.resize(0);
+        }
+    }
+
+    return result;
+}
+
+static void Report(const char* name, ReplayResult_t& result)
+{
+    auto& latencies = result.EventLatencies;
+    if (latencies.empty() || result.Events == 0)
+    {
+        printf("%-16s no events replayed\n", name);
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[std::min(latencies.size() - 1, (size_t)(p * latencies.size()))]; };
+
+    printf("%-16s %10.0f events/s   p50 %8.0f ns   p90 %8.0f ns   p99 %8.0f ns   max %8.0f ns   %.3f allocations/event\n",
+        name,
+        result.Events / result.Seconds,
+        percentile(0.5), percentile(0.9), percentile(0.99), latencies.back(),
+        (double)result.Allocations / result.Events);
+}
+
+static int Replay(const char* path, int repeat)
+{
+    std::vector<TraceEvent_t> events;
+    if (!ReadTrace(path, events) || events.empty())
+    {
+        printf("Failed to read %s\n", path);
+        return 1;
+    }
+
+    XInitThreads();
+
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        printf("Failed to open X display, run it under Xvfb.\n");
+        return 1;
+    }
+
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = ImVec2(1280.0f, 720.0f);
+
+    // The replayed events are pushed straight into the queue, the window doesn't need to select anything.
+    Window window = CreateWindow(display, NoEventMask);
+
+    auto hook = InGameOverlay::X11Hook_t::Inst();
+    std::function<void()> keyCombinationCallback = []() {};
+    InGameOverlay::ToggleKey toggleKeys[] = { InGameOverlay::ToggleKey::SHIFT, InGameOverlay::ToggleKey::F2 };
+    if (!hook->StartHook(keyCombinationCallback, toggleKeys, 2))
+    {
+        printf("Failed to hook X11.\n");
+        return 1;
+    }
+
+    ReportGameDisplay(display, window);
+    hook->PrepareForOverlay(window);
+    // Leave the input thread some time to start, the closed overlay path depends on it.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    printf("%zu events, %d passes\n", events.size(), repeat);
+
+    struct
+    {
+        const char* Name;
+        bool OverlayVisible;
+    } configurations[] = {
+        { "overlay hidden" , false },
+        { "overlay visible", true  },
+    };
+
+    for (auto const& configuration : configurations)
+    {
+        hook->HideOverlayInputs(!configuration.OverlayVisible);
+        hook->HideAppInputs(configuration.OverlayVisible);
+        hook->PrepareForOverlay(window);
+
+        auto result = ReplayTrace(display, window, events, repeat);
+        Report(configuration.Name, result);
+    }
+
+    printf("%llu events coalesced\n", (unsigned long long)hook->GetCoalescedEventCount());
+
+    delete hook;
+    ImGui::DestroyContext();
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 3 && strcmp(argv[1], "record") == 0)
+        return Record(argv[2], argc > 3 ? (uint32_t)atoi(argv[3]) : 10000);
+
+    if (argc >= 3 && strcmp(argv[1], "synthesize") == 0)
+        return Synthesize(argv[2], argc > 3 ? (uint32_t)atoi(argv[3]) : 100000);
+
+    if (argc >= 3 && strcmp(argv[1], "replay") == 0)
+        return Replay(argv[2], argc > 3 ? std::max(1, atoi(argv[3])) : 10);
+
+    printf("Usage:\n"
+        "  %s record <file> [events]\n"
+        "  %s synthesize <file> [events]\n"
+        "  %s replay <file> [repeat]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
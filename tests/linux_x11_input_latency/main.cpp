@@ -0,0 +1,221 @@
+// Measures how many frames an input takes to reach the overlay, with and without the dedicated X11 input thread.
+// Keys are pressed through XTest while the "game" only polls its events every few frames. Run it under Xvfb:
+//   Xvfb :99 -screen 0 1280x720x24 &
+//   DISPLAY=:99 ./linux_x11_input_latency [presses] [frames between polls]
+
+// The overlay headers must come first, Xlib defines macros like None and Status.
+#include "Linux/X11Hook.h"
+
+#include <X11/extensions/XTest.h>
+#include <X11/keysym.h>
+
+#undef Status
+
+#include <imgui.h>
+#include <imgui_internal.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr auto FrameDuration = std::chrono::microseconds(16667);
+
+struct LatencySample_t
+{
+    double Milliseconds;
+    int Frames;
+};
+
+static Window CreateGameWindow(Display* display)
+{
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 640, 480, 0, 0, 0);
+    // No button selection, the input thread needs them on the window.
+    XSelectInput(display, window, KeyPressMask | KeyReleaseMask | FocusChangeMask | StructureNotifyMask);
+    XMapWindow(display, window);
+
+    XEvent event;
+    do
+    {
+        XNextEvent(display, &event);
+    } while (event.type != MapNotify);
+
+    XSetInputFocus(display, window, RevertToParent, CurrentTime);
+    XSync(display, False);
+
+    return window;
+}
+
+// The hook learns the game display from the hooked XPending, it needs at least one event to look at.
+static void ReportGameDisplay(Display* display, Window window)
+{
+    XEvent event{};
+    event.type = ClientMessage;
+    event.xclient.window = window;
+    event.xclient.format = 32;
+    XPutBackEvent(display, &event);
+
+    while (XPending(display))
+        XNextEvent(display, &event);
+}
+
+static bool OverlayReceivedKey(ImGuiKey key)
+{
+    auto& queue = ImGui::GetCurrentContext()->InputEventsQueue;
+    bool found = false;
+    for (auto const& inputEvent : queue)
+    {
+        if (inputEvent.Type == ImGuiInputEventType_Key && inputEvent.Key.Key == key && inputEvent.Key.Down)
+            found = true;
+    }
+
+    // ImGui::NewFrame is never called, drop the events ourselves.
+    queue.resize(0);
+    return found;
+}
+
+static std::vector<LatencySample_t> MeasureLatency(Display* display, Display* sender, Window window, int presses, int pollInterval)
+{
+    auto hook = InGameOverlay::X11Hook_t::Inst();
+    const KeyCode keyCode = XKeysymToKeycode(sender, XK_a);
+
+    std::vector<LatencySample_t> samples;
+    Clock::time_point pressTime;
+    int pressFrame = 0;
+    bool waiting = false;
+    // Spread the presses so they land at every point of the polling interval.
+    const int framesBetweenPresses = pollInterval + 3;
+
+    auto nextFrame = Clock::now();
+    for (int frame = 0; (int)samples.size() < presses && frame < presses * framesBetweenPresses * 4; ++frame)
+    {
+        if (!waiting && frame % framesBetweenPresses == 0)
+        {
+            XTestFakeKeyEvent(sender, keyCode, True, CurrentTime);
+            XTestFakeKeyEvent(sender, keyCode, False, CurrentTime);
+            XFlush(sender);
+            pressTime = Clock::now();
+            pressFrame = frame;
+            waiting = true;
+        }
+
+        // The game only looks at its events from time to time.
+        if (frame % pollInterval == 0)
+        {
+            XEvent event;
+            while (XPending(display))
+                XNextEvent(display, &event);
+        }
+
+        hook->PrepareForOverlay(window);
+
+        if (OverlayReceivedKey(ImGuiKey_A) && waiting)
+        {
+            samples.emplace_back(LatencySample_t{
+                std::chrono::duration<double, std::milli>(Clock::now() - pressTime).count(),
+                frame - pressFrame });
+            waiting = false;
+        }
+
+        nextFrame += FrameDuration;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    return samples;
+}
+
+static void Report(const char* name, std::vector<LatencySample_t> samples, int presses)
+{
+    if (samples.empty())
+    {
+        printf("%-20s no input reached the overlay\n", name);
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end(), [](LatencySample_t const& a, LatencySample_t const& b) { return a.Milliseconds < b.Milliseconds; });
+    auto percentile = [&](double p) { return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]; };
+
+    printf("%-20s %3zu/%d inputs   median %6.2f ms (%d frames)   p95 %6.2f ms (%d frames)   max %6.2f ms (%d frames)\n",
+        name, samples.size(), presses,
+        percentile(0.5).Milliseconds, percentile(0.5).Frames,
+        percentile(0.95).Milliseconds, percentile(0.95).Frames,
+        samples.back().Milliseconds, samples.back().Frames);
+}
+
+int main(int argc, char* argv[])
+{
+    int presses = argc > 1 ? atoi(argv[1]) : 50;
+    int pollInterval = argc > 2 ? atoi(argv[2]) : 4;
+    if (presses <= 0 || pollInterval <= 0)
+    {
+        printf("Usage: %s [presses] [frames between polls]\n", argv[0]);
+        return 1;
+    }
+
+    XInitThreads();
+
+    Display* display = XOpenDisplay(nullptr);
+    Display* sender = XOpenDisplay(nullptr);
+    if (display == nullptr || sender == nullptr)
+    {
+        printf("Failed to open X display, run it under Xvfb.\n");
+        return 1;
+    }
+
+    int xtestEvent, xtestError, xtestMajor, xtestMinor;
+    if (!XTestQueryExtension(sender, &xtestEvent, &xtestError, &xtestMajor, &xtestMinor))
+    {
+        printf("The XTest extension is not available.\n");
+        return 1;
+    }
+
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = ImVec2(640.0f, 480.0f);
+
+    Window window = CreateGameWindow(display);
+
+    auto hook = InGameOverlay::X11Hook_t::Inst();
+    std::function<void()> keyCombinationCallback = []() {};
+    InGameOverlay::ToggleKey toggleKeys[] = { InGameOverlay::ToggleKey::SHIFT, InGameOverlay::ToggleKey::F2 };
+    if (!hook->StartHook(keyCombinationCallback, toggleKeys, 2))
+    {
+        printf("Failed to hook X11.\n");
+        return 1;
+    }
+
+    ReportGameDisplay(display, window);
+
+    printf("%d presses, the game polls its events every %d frames\n", presses, pollInterval);
+
+    for (bool dedicatedThread : { false, true })
+    {
+        hook->SetDedicatedInputThread(dedicatedThread);
+        hook->PrepareForOverlay(window);
+        hook->HideOverlayInputs(false);
+        hook->HideAppInputs(true);
+        // Leave the input thread some time to select its events, the next frame picks up its result.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        hook->PrepareForOverlay(window);
+        OverlayReceivedKey(ImGuiKey_A);
+
+        if (dedicatedThread && !hook->SetDedicatedInputThread(true))
+        {
+            printf("%-20s the input thread is not available\n", "dedicated thread");
+            continue;
+        }
+
+        Report(dedicatedThread ? "dedicated thread" : "application polling", MeasureLatency(display, sender, window, presses, pollInterval), presses);
+    }
+
+    delete hook;
+    ImGui::DestroyContext();
+    XDestroyWindow(display, window);
+    XCloseDisplay(sender);
+    XCloseDisplay(display);
+
+    return 0;
+}
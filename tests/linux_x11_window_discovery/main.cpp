@@ -0,0 +1,236 @@
+// Benchmarks X11Hook_t::FindApplicationX11Window against a synthetic window tree.
+// Run it on an empty X server:
+//   Xvfb :99 -screen 0 1280x720x24 &
+//   DISPLAY=:99 ./linux_x11_window_discovery [children per window] [depth] [iterations] [--client-list]
+// --client-list publishes the deepest windows in _NET_CLIENT_LIST, like a window manager would.
+
+// The overlay headers must come first, Xlib defines macros like None and Status.
+#include "Linux/X11Hook.h"
+
+#include <X11/Xatom.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct SyntheticTree_t
+{
+    std::vector<Window> Windows;
+    std::vector<Window> Leaves;
+    Window Target;
+};
+
+static SyntheticTree_t BuildSyntheticTree(Display* display, int childrenPerWindow, int depth, long processId)
+{
+    SyntheticTree_t tree;
+    Atom pidAtom = XInternAtom(display, "_NET_WM_PID", False);
+    long otherProcessId = processId + 1;
+
+    std::vector<Window> parents{ DefaultRootWindow(display) };
+    std::vector<Window> children;
+    for (int level = 0; level < depth; ++level)
+    {
+        children.clear();
+        for (auto parent : parents)
+        {
+            for (int i = 0; i < childrenPerWindow; ++i)
+            {
+                Window window = XCreateSimpleWindow(display, parent, 0, 0, 16, 16, 0, 0, 0);
+                XChangeProperty(display, window, pidAtom, XA_CARDINAL, 32, PropModeReplace, (unsigned char*)&otherProcessId, 1);
+                children.emplace_back(window);
+                tree.Windows.emplace_back(window);
+            }
+        }
+        std::swap(parents, children);
+    }
+
+    tree.Leaves = parents;
+    // The last window created is the deepest one, the worst case for the tree walk.
+    tree.Target = tree.Windows.back();
+    XChangeProperty(display, tree.Target, pidAtom, XA_CARDINAL, 32, PropModeReplace, (unsigned char*)&processId, 1);
+    XSync(display, False);
+
+    return tree;
+}
+
+// The lookup as it was done before: a new connection and one synchronous request per window.
+static void FindWindowsXlib(Display* display, Window window, Atom pidAtom, long processId, std::vector<Window>& result)
+{
+    Atom type;
+    int format;
+    unsigned long itemCount, bytesAfter;
+    unsigned char* value = nullptr;
+    if (XGetWindowProperty(display, window, pidAtom, 0, 1, False, XA_CARDINAL, &type, &format, &itemCount, &bytesAfter, &value) == Success && value != nullptr)
+    {
+        if (itemCount == 1 && *(long*)value == processId)
+            result.emplace_back(window);
+
+        XFree(value);
+    }
+
+    Window root, parent;
+    Window* children = nullptr;
+    unsigned int childCount = 0;
+    if (!XQueryTree(display, window, &root, &parent, &children, &childCount))
+        return;
+
+    for (unsigned int i = 0; i < childCount; ++i)
+        FindWindowsXlib(display, children[i], pidAtom, processId, result);
+
+    if (children != nullptr)
+        XFree(children);
+}
+
+static std::vector<Window> FindApplicationWindowsXlib(long processId)
+{
+    std::vector<Window> result;
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+        return result;
+
+    FindWindowsXlib(display, DefaultRootWindow(display), XInternAtom(display, "_NET_WM_PID", False), processId, result);
+    XCloseDisplay(display);
+
+    return result;
+}
+
+static void Report(const char* name, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (auto sample : samples)
+        total += sample;
+
+    printf("%-28s min %10.1f us   median %10.1f us   mean %10.1f us   max %10.1f us\n",
+        name,
+        samples.front(),
+        samples[samples.size() / 2],
+        total / samples.size(),
+        samples.back());
+}
+
+static bool Measure(const char* name, int iterations, Window expected, std::function<void()> const& prepare, std::function<std::vector<Window>()> const& lookup)
+{
+    std::vector<double> samples;
+    for (int i = 0; i < iterations; ++i)
+    {
+        prepare();
+
+        auto start = Clock::now();
+        auto windows = lookup();
+        auto end = Clock::now();
+
+        if (std::find(windows.begin(), windows.end(), expected) == windows.end())
+        {
+            printf("%s: the target window was not found.\n", name);
+            return false;
+        }
+
+        samples.emplace_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    Report(name, samples);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    int childrenPerWindow = 10;
+    int depth = 3;
+    int iterations = 20;
+    bool publishClientList = false;
+
+    int position = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--client-list") == 0)
+        {
+            publishClientList = true;
+            continue;
+        }
+
+        switch (position++)
+        {
+            case 0: childrenPerWindow = atoi(argv[i]); break;
+            case 1: depth = atoi(argv[i]); break;
+            case 2: iterations = atoi(argv[i]); break;
+        }
+    }
+
+    if (childrenPerWindow <= 0 || depth <= 0 || iterations <= 0)
+    {
+        printf("Usage: %s [children per window] [depth] [iterations] [--client-list]\n", argv[0]);
+        return 1;
+    }
+
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        printf("Failed to open X display, run it under Xvfb.\n");
+        return 1;
+    }
+
+    const long processId = getpid();
+    auto tree = BuildSyntheticTree(display, childrenPerWindow, depth, processId);
+
+    Atom clientListAtom = XInternAtom(display, "_NET_CLIENT_LIST", False);
+    if (publishClientList)
+        XChangeProperty(display, DefaultRootWindow(display), clientListAtom, XA_WINDOW, 32, PropModeReplace, (unsigned char*)tree.Leaves.data(), (int)tree.Leaves.size());
+    else
+        XDeleteProperty(display, DefaultRootWindow(display), clientListAtom);
+    XSync(display, False);
+
+    printf("%zu windows, %d children per window, %d levels, _NET_CLIENT_LIST %s\n",
+        tree.Windows.size(), childrenPerWindow, depth, publishClientList ? "published" : "absent");
+
+    auto hook = InGameOverlay::X11Hook_t::Inst();
+    const int32_t missingProcessId = (int32_t)processId + 2;
+
+    bool success = Measure("Xlib tree walk", iterations, tree.Target,
+        []() {},
+        [&]() { return FindApplicationWindowsXlib(processId); });
+
+    // Looking for another process first drops the cached result.
+    success = success && Measure("X11Hook_t uncached", iterations, tree.Target,
+        [&]() { hook->FindApplicationX11Window(missingProcessId); },
+        [&]() { return hook->FindApplicationX11Window((int32_t)processId); });
+
+    success = success && Measure("X11Hook_t cached", iterations, tree.Target,
+        []() {},
+        [&]() { return hook->FindApplicationX11Window((int32_t)processId); });
+
+    // A window mapped after the first lookup must drop the cache.
+    Window lateWindow = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 16, 16, 0, 0, 0);
+    XChangeProperty(display, lateWindow, XInternAtom(display, "_NET_WM_PID", False), XA_CARDINAL, 32, PropModeReplace, (unsigned char*)&processId, 1);
+    XMapWindow(display, lateWindow);
+    XSync(display, False);
+    // Leave the server some time to send the notifications to the hook connection.
+    usleep(10000);
+
+    auto windows = hook->FindApplicationX11Window((int32_t)processId);
+    if (std::find(windows.begin(), windows.end(), lateWindow) == windows.end())
+    {
+        printf("The window mapped after the first lookup was not found.\n");
+        success = false;
+    }
+
+    if (publishClientList)
+        XDeleteProperty(display, DefaultRootWindow(display), clientListAtom);
+
+    XDestroyWindow(display, lateWindow);
+    for (auto it = tree.Windows.rbegin(); it != tree.Windows.rend(); ++it)
+        XDestroyWindow(display, *it);
+
+    XCloseDisplay(display);
+    delete hook;
+
+    return success ? 0 : 1;
+}
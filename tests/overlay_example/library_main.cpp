@@ -9,7 +9,7 @@
 #define STB_IMAGE_STATIC
 #define STBI_ONLY_PNG
 #define STBI_NO_STDIO
-#include "../common/stb_image.h"
+#include "../../deps/stb/stb_image.h"
 #include "../common/thumbs_up.h"
 #include "../common/thumbs_down.h"
 #include "../common/thumbs_down_small.h"
@@ -460,6 +460,8 @@ void shared_library_load(void* hmodule)
 
             if (hookState == InGameOverlay::OverlayHookState::Removing)
             {
+                // The borrowed images would be uploaded again once the hook is ready, they are still recreated
+                // like an application attaching owned data has to (see RendererResource_t::IsLost).
                 if (OverlayData->OverlayImage1 != nullptr && OverlayData->OverlayImage1->GetResourceId() != 0)
                     OverlayData->OverlayImage1->Unload();
 
@@ -0,0 +1,136 @@
+// Measures what an animation costs with one texture per frame, against a single texture holding
+// the same pixels like an atlas of the frames would. It runs against a renderer without a device,
+// so it reports the library side: attaching, loading every frame and looking the current frame up.
+//   ./resource_animation [frame width] [frame height] [GetResourceId calls]
+
+#include "../common/fake_renderer_hook.h"
+#include "RendererResourceInternal.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Measure_t
+{
+    double AttachUs;
+    double LoadUs;
+    uint32_t LoadFrames;
+    double GetResourceIdNs;
+    uint32_t Textures;
+};
+
+static double ElapsedUs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+template<typename F>
+static bool Run(uint32_t textures, uint32_t calls, F&& attach, Measure_t& measure)
+{
+    FakeRendererHook_t hook;
+    hook.SetAutoLoadBatchSize(textures);
+
+    auto resource = hook.CreateResource();
+
+    auto start = Clock::now();
+    attach(resource);
+    measure.AttachUs = ElapsedUs(start);
+
+    start = Clock::now();
+    resource->Prefetch();
+    measure.LoadFrames = 0;
+    while (!resource->IsLoaded() && measure.LoadFrames < 16)
+    {
+        hook.RunFrame();
+        ++measure.LoadFrames;
+    }
+    measure.LoadUs = ElapsedUs(start);
+
+    if (!resource->IsLoaded())
+    {
+        resource->Delete();
+        return false;
+    }
+
+    // Drawn once per present, so the lookup runs once per frame like it would in OverlayProc.
+    uint64_t sum = 0;
+    start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i)
+    {
+        hook.RunFrame();
+        sum += resource->GetResourceId();
+    }
+    const double framesUs = ElapsedUs(start);
+
+    start = Clock::now();
+    for (uint32_t i = 0; i < calls; ++i)
+        hook.RunFrame();
+
+    // Only what GetResourceId adds to the frames.
+    measure.GetResourceIdNs = std::max(0.0, framesUs - ElapsedUs(start)) * 1000.0 / calls;
+
+    hook.RunFrame();
+    measure.Textures = hook.GetResourceStats().Textures;
+
+    resource->Delete();
+    hook.RunFrame();
+    return sum != 0;
+}
+
+static void Report(const char* name, Measure_t const& measure)
+{
+    printf("  %-22s attach %10.1f us   load %10.1f us in %2u frames   GetResourceId %8.1f ns   textures %4u\n",
+        name,
+        measure.AttachUs,
+        measure.LoadUs,
+        measure.LoadFrames,
+        measure.GetResourceIdNs,
+        measure.Textures);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t width = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 64;
+    uint32_t height = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 64;
+    uint32_t calls = argc > 3 ? static_cast<uint32_t>(atoi(argv[3])) : 1000;
+
+    if (width == 0 || height == 0 || calls == 0)
+    {
+        printf("Usage: %s [frame width] [frame height] [GetResourceId calls]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Per frame bookkeeping: resource %zu bytes, texture %zu bytes\n",
+        sizeof(InGameOverlay::RendererResourceInternal_t),
+        sizeof(InGameOverlay::RendererTexture_t));
+
+    bool success = true;
+    for (uint32_t frameCount : { 8u, 64u, 256u })
+    {
+        std::vector<uint8_t> frames(size_t(width) * height * 4 * frameCount);
+        for (size_t i = 0; i < frames.size(); ++i)
+            frames[i] = static_cast<uint8_t>(i * 31 + i / 4096);
+
+        std::vector<uint32_t> durations(frameCount, 16);
+
+        printf("%u frames of %ux%u\n", frameCount, width, height);
+
+        Measure_t animation;
+        success &= Run(frameCount, calls, [&](InGameOverlay::RendererResource_t* resource)
+        {
+            resource->AttachAnimation(frames.data(), durations.data(), frameCount, width, height);
+        }, animation);
+        Report("texture per frame", animation);
+
+        Measure_t single;
+        success &= Run(1, calls, [&](InGameOverlay::RendererResource_t* resource)
+        {
+            resource->AttachResource(frames.data(), width, height * frameCount);
+        }, single);
+        Report("single texture", single);
+    }
+
+    return success ? 0 : 1;
+}
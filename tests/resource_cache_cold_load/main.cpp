@@ -0,0 +1,258 @@
+// Times cold loads of decoded image cache entries: the old read path, which reads the pixels into the heap
+// before attaching them, against AttachResourceFromFile, which maps them with MADV_SEQUENTIAL and uploads
+// straight from the mapping. The entries are dropped from the page cache before every cold run, this only
+// works on a disk backed file system, the resident pages are reported to tell. It runs against a renderer
+// without a device, its upload reads every byte like a staging copy does.
+//   ./resource_cache_cold_load [entries] [entry width] [iterations] [directory]
+
+#include "../common/fake_renderer_hook.h"
+#include "ResourceCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct Entry_t
+{
+    std::string Path;
+    uint64_t Hash;
+    uint64_t Checksum;
+};
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static uint64_t Checksum(const uint8_t* bytes, size_t size)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i += 64)
+        sum = sum * 31 + bytes[i];
+
+    return sum;
+}
+
+// Written pages must reach the disk before the kernel agrees to drop them.
+static bool EvictEntry(std::string const& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    const bool evicted = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+}
+
+static double ResidentFraction(std::string const& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 1.0;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        return 1.0;
+    }
+
+    const size_t size = static_cast<size_t>(fileStat.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return 1.0;
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+    size_t resident = 0;
+    if (mincore(view, size, pages.data()) == 0)
+        resident = static_cast<size_t>(std::count_if(pages.begin(), pages.end(), [](unsigned char page) { return (page & 1) != 0; }));
+    else
+        resident = pages.size();
+
+    munmap(view, size);
+    return double(resident) / double(pages.size());
+}
+
+// What attaching a cache entry did before AttachResourceFromFile.
+static bool AttachRead(InGameOverlay::RendererResource_t* resource, std::string const& path, uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.seekg(static_cast<std::streamoff>(InGameOverlay::ResourceCachePixelsOffset)) ||
+        !file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size())))
+        return false;
+
+    resource->AttachResource(std::move(pixels), width, height);
+    return true;
+}
+
+static bool AttachMapped(InGameOverlay::RendererResource_t* resource, std::string const& path, uint32_t width, uint32_t height)
+{
+    return resource->AttachResourceFromFile(path.c_str(), width, height, InGameOverlay::ResourceCachePixelsOffset);
+}
+
+// Validates every entry, attaches it and runs frames until the textures are all uploaded.
+template<typename F>
+static bool LoadEntries(std::vector<Entry_t> const& entries, uint32_t width, F&& attach, double& elapsedMs)
+{
+    FakeRendererHook_t hook;
+    hook.SetAutoLoadBatchSize(static_cast<uint32_t>(entries.size()));
+
+    std::vector<InGameOverlay::RendererResource_t*> resources;
+    resources.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+        resources.emplace_back(hook.CreateResource());
+
+    bool success = true;
+    auto start = Clock::now();
+    for (size_t i = 0; i < entries.size() && success; ++i)
+    {
+        uint32_t entryWidth;
+        uint32_t entryHeight;
+        success = InGameOverlay::ReadResourceCacheEntry(entries[i].Path, entries[i].Hash, entryWidth, entryHeight) &&
+            entryWidth == width &&
+            attach(resources[i], entries[i].Path, entryWidth, entryHeight) &&
+            resources[i]->Prefetch();
+    }
+
+    for (int i = 0; i < 4 && success && !std::all_of(resources.begin(), resources.end(), [](InGameOverlay::RendererResource_t* resource) { return resource->IsLoaded(); }); ++i)
+        hook.RunFrame();
+
+    elapsedMs = ElapsedMs(start);
+
+    for (size_t i = 0; i < entries.size() && success; ++i)
+    {
+        auto texture = hook.FindTexture(resources[i]->GetResourceId());
+        success = texture != nullptr && Checksum(texture->Pixels.data(), texture->Pixels.size()) == entries[i].Checksum;
+    }
+
+    // Unmaps the entries before they are evicted again.
+    for (auto resource : resources)
+        resource->Delete();
+    hook.RunFrame();
+
+    return success;
+}
+
+static void Report(const char* name, std::vector<double>& samples, size_t bytes)
+{
+    std::sort(samples.begin(), samples.end());
+    const double median = samples[samples.size() / 2];
+    printf("  %-12s min %8.2f ms   median %8.2f ms   max %8.2f ms   %8.1f MiB/s\n",
+        name,
+        samples.front(),
+        median,
+        samples.back(),
+        median > 0.0 ? double(bytes) / (1024.0 * 1024.0) / (median / 1000.0) : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t count = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 32;
+    uint32_t width = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 1024;
+    uint32_t iterations = argc > 3 ? static_cast<uint32_t>(atoi(argv[3])) : 5;
+    std::string directory = argc > 4 ? argv[4] : ".";
+
+    if (count == 0 || width == 0 || iterations == 0)
+    {
+        printf("Usage: %s [entries] [entry width] [iterations] [directory]\n", argv[0]);
+        return 1;
+    }
+
+    // The default directory is the working one, /tmp is often a tmpfs its pages can't be dropped from.
+    std::string cacheDirectory = directory + "/resource_cache_cold_load.XXXXXX";
+    if (mkdtemp(&cacheDirectory[0]) == nullptr)
+    {
+        printf("Failed to create a directory in %s.\n", directory.c_str());
+        return 1;
+    }
+
+    const uint32_t height = width;
+    const size_t entrySize = size_t(width) * height * 4;
+    std::vector<Entry_t> entries(count);
+    std::vector<uint8_t> pixels(entrySize);
+    bool success = true;
+    for (uint32_t i = 0; i < count && success; ++i)
+    {
+        for (size_t j = 0; j < pixels.size(); ++j)
+            pixels[j] = static_cast<uint8_t>(j * 31 + j / 4096 + i * 7);
+
+        entries[i].Hash = 0x9E3779B97F4A7C15ull * (i + 1);
+        entries[i].Path = InGameOverlay::GetResourceCachePath(cacheDirectory, entries[i].Hash);
+        entries[i].Checksum = Checksum(pixels.data(), pixels.size());
+        success = InGameOverlay::WriteResourceCacheEntry(entries[i].Path, entries[i].Hash, pixels.data(), width, height);
+    }
+
+    printf("%u cache entries of %ux%u in %s, %u iterations\n", count, width, height, cacheDirectory.c_str(), iterations);
+
+    struct Method_t
+    {
+        const char* Name;
+        bool(*Attach)(InGameOverlay::RendererResource_t*, std::string const&, uint32_t, uint32_t);
+        std::vector<double> Cold;
+        std::vector<double> Warm;
+    };
+    Method_t methods[] = {
+        { "read", &AttachRead, {}, {} },
+        { "mmap", &AttachMapped, {}, {} },
+    };
+
+    double resident = 0.0;
+    for (uint32_t i = 0; i < iterations && success; ++i)
+    {
+        // Alternated so neither method always runs right after the writes.
+        for (uint32_t m = 0; m < 2 && success; ++m)
+        {
+            auto& method = methods[(i + m) % 2];
+
+            for (auto const& entry : entries)
+                success &= EvictEntry(entry.Path);
+
+            for (auto const& entry : entries)
+                resident += ResidentFraction(entry.Path);
+
+            double elapsedMs;
+            success &= LoadEntries(entries, width, method.Attach, elapsedMs);
+            method.Cold.emplace_back(elapsedMs);
+
+            // Everything is in the page cache now.
+            success &= LoadEntries(entries, width, method.Attach, elapsedMs);
+            method.Warm.emplace_back(elapsedMs);
+        }
+    }
+
+    if (success)
+    {
+        printf("Resident after eviction: %.1f%%\n", resident * 100.0 / (double(iterations) * 2 * count));
+        printf("Cold\n");
+        for (auto& method : methods)
+            Report(method.Name, method.Cold, entrySize * count);
+
+        printf("Warm\n");
+        for (auto& method : methods)
+            Report(method.Name, method.Warm, entrySize * count);
+    }
+    else
+    {
+        printf("The cache entries were not all written, evicted and loaded.\n");
+    }
+
+    for (auto const& entry : entries)
+        std::remove(entry.Path.c_str());
+    rmdir(cacheDirectory.c_str());
+
+    return success ? 0 : 1;
+}
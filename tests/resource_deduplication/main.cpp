@@ -0,0 +1,66 @@
+// Checks that a deduplicated texture doesn't read the pixels of the resource that issued its load
+// once that resource is gone. The issuer is deleted while its load is still queued and its borrowed
+// pixels are freed, the resource still sharing the texture must get the attached content.
+//   ./resource_deduplication
+
+#include "../common/fake_renderer_hook.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+static std::vector<uint8_t> MakePixels(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = static_cast<uint8_t>(i * 31 + 7);
+
+    return pixels;
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t width = 64;
+    const uint32_t height = 64;
+
+    FakeRendererHook_t hook;
+    hook.SetResourceDeduplication(true);
+
+    const auto expected = MakePixels(width, height);
+    auto issuerPixels = new std::vector<uint8_t>(expected);
+    std::vector<uint8_t> sharerPixels(expected);
+
+    auto issuer = hook.CreateResource();
+    auto sharer = hook.CreateResource();
+    issuer->AttachResource(issuerPixels->data(), width, height);
+    sharer->AttachResource(sharerPixels.data(), width, height);
+
+    // The content hash is computed on the decode pool, the load is only queued once it is done.
+    // The issuer queues the load, the sharer finds the texture already loading.
+    if (!WaitFor([&]() { return issuer->Prefetch(); }) || !WaitFor([&]() { return sharer->Prefetch(); }))
+    {
+        printf("The content hash was not computed.\n");
+        return 1;
+    }
+
+    issuer->Delete();
+    // Whatever reads them from now on doesn't see the attached content.
+    std::fill(issuerPixels->begin(), issuerPixels->end(), uint8_t(0xCD));
+    delete issuerPixels;
+
+    for (int i = 0; i < 4 && !sharer->IsLoaded(); ++i)
+        hook.RunFrame();
+
+    auto texture = hook.FindTexture(sharer->GetResourceId());
+    const bool success = sharer->IsLoaded() && hook.Uploads == 1 && texture != nullptr && texture->Pixels == expected;
+    printf("Shared texture loaded: %s, uploads: %u, pixels: %s\n",
+        sharer->IsLoaded() ? "yes" : "no",
+        hook.Uploads,
+        texture != nullptr && texture->Pixels == expected ? "attached content" : "wrong");
+
+    sharer->Delete();
+    hook.RunFrame();
+
+    printf("%s\n", success ? "PASSED" : "FAILED");
+    return success ? 0 : 1;
+}
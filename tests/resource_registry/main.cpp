@@ -0,0 +1,186 @@
+// Benchmarks the texture registry with many live resources: the slot map the textures are looked up in,
+// and the queues loads and releases go through. It runs against a renderer without a device, so only
+// the library side is measured.
+//   ./resource_registry [resources] [iterations]
+
+#include "../common/fake_renderer_hook.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedNs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+static void Report(const char* name, std::vector<double>& samples, uint32_t count)
+{
+    std::sort(samples.begin(), samples.end());
+    printf("%-34s min %8.1f ns   median %8.1f ns   max %8.1f ns   per call\n",
+        name,
+        samples.front() / count,
+        samples[samples.size() / 2] / count,
+        samples.back() / count);
+}
+
+// The registry as it was: textures in a pointer ordered set, resources keeping a weak_ptr to theirs.
+static void MeasureSetRegistry(uint32_t count, uint32_t iterations)
+{
+    std::set<std::shared_ptr<InGameOverlay::RendererTexture_t>> textures;
+    std::vector<std::weak_ptr<InGameOverlay::RendererTexture_t>> resources;
+    resources.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto texture = std::make_shared<InGameOverlay::RendererTexture_t>();
+        texture->ImGuiTextureId = i + 1;
+        resources.emplace_back(texture);
+        textures.emplace(std::move(texture));
+    }
+
+    std::vector<double> samples;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        auto start = Clock::now();
+        for (auto& resource : resources)
+        {
+            auto texture = resource.lock();
+            if (texture != nullptr)
+                sum += texture->ImGuiTextureId;
+        }
+        samples.emplace_back(ElapsedNs(start));
+    }
+
+    Report("std::set + weak_ptr::lock lookup", samples, count);
+    if (sum == 0)
+        printf("Nothing was looked up.\n");
+}
+
+static void MeasureSlotMapRegistry(uint32_t count, uint32_t iterations)
+{
+    InGameOverlay::SlotMap_t<std::shared_ptr<InGameOverlay::RendererTexture_t>> textures;
+    std::vector<InGameOverlay::RendererTextureHandle_t> resources;
+    resources.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto texture = std::make_shared<InGameOverlay::RendererTexture_t>();
+        texture->ImGuiTextureId = i + 1;
+        resources.emplace_back(textures.Insert(std::move(texture)));
+    }
+
+    std::vector<double> samples;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        auto start = Clock::now();
+        for (auto resource : resources)
+        {
+            auto texture = textures.Get(resource);
+            if (texture != nullptr)
+                sum += (*texture)->ImGuiTextureId;
+        }
+        samples.emplace_back(ElapsedNs(start));
+    }
+
+    Report("slot map lookup", samples, count);
+    if (sum == 0)
+        printf("Nothing was looked up.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t count = argc > 1 ? static_cast<uint32_t>(atoi(argv[1])) : 20000;
+    uint32_t iterations = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 10;
+
+    if (count == 0 || iterations == 0)
+    {
+        printf("Usage: %s [resources] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%u live resources, %u iterations\n", count, iterations);
+
+    MeasureSetRegistry(count, iterations);
+    MeasureSlotMapRegistry(count, iterations);
+
+    // Tiny images, the uploads of the fake renderer are a copy and must not hide the registry.
+    const uint32_t size = 4;
+    std::vector<uint8_t> pixels(size * size * 4, 0x80);
+
+    std::vector<double> prefetchSamples;
+    std::vector<double> getResourceIdSamples;
+    std::vector<double> unloadSamples;
+    std::vector<double> loadFrameSamples;
+    std::vector<double> releaseFrameSamples;
+    bool success = true;
+
+    FakeRendererHook_t hook;
+    hook.SetAutoLoadBatchSize(count);
+
+    std::vector<InGameOverlay::RendererResource_t*> resources(count);
+    std::vector<InGameOverlay::RendererResourceDesc_t> descs(count);
+    for (auto& desc : descs)
+        desc = InGameOverlay::RendererResourceDesc_t{ pixels.data(), size, size, InGameOverlay::RendererResourcePriority_t::Normal, InGameOverlay::RendererResourceFormat_t::RGBA8 };
+
+    hook.CreateResources(count, descs.data(), resources.data());
+
+    for (uint32_t i = 0; i < iterations && success; ++i)
+    {
+        // Queues every load from the application side.
+        auto start = Clock::now();
+        for (auto resource : resources)
+            resource->Prefetch();
+        prefetchSamples.emplace_back(ElapsedNs(start));
+
+        // Drains the load queue, schedules and uploads.
+        start = Clock::now();
+        hook.RunFrame();
+        loadFrameSamples.emplace_back(ElapsedNs(start));
+
+        success = std::all_of(resources.begin(), resources.end(), [](InGameOverlay::RendererResource_t* resource) { return resource->IsLoaded(); });
+
+        // Every resource drawn once, like a long list in OverlayProc.
+        uint64_t sum = 0;
+        start = Clock::now();
+        for (auto resource : resources)
+            sum += resource->GetResourceId();
+        getResourceIdSamples.emplace_back(ElapsedNs(start));
+        success &= sum != 0;
+
+        // Queues every release, the data stays attached for the next iteration.
+        start = Clock::now();
+        for (auto resource : resources)
+            resource->Unload(false);
+        unloadSamples.emplace_back(ElapsedNs(start));
+
+        // Drains the release queue and frees the slots.
+        start = Clock::now();
+        hook.RunFrame();
+        releaseFrameSamples.emplace_back(ElapsedNs(start));
+    }
+
+    if (success)
+    {
+        Report("Prefetch", prefetchSamples, count);
+        Report("GetResourceId", getResourceIdSamples, count);
+        Report("Unload", unloadSamples, count);
+        Report("load frame, per resource", loadFrameSamples, count);
+        Report("release frame, per resource", releaseFrameSamples, count);
+    }
+    else
+    {
+        printf("The resources were not all loaded in one frame.\n");
+    }
+
+    for (auto resource : resources)
+        resource->Delete();
+    hook.RunFrame();
+
+    return success ? 0 : 1;
+}
@@ -128,6 +128,7 @@ target("ingame_overlay")
     add_includedirs("deps/ImGui/misc/cpp")
     add_includedirs("src/VulkanSDK/include", {public = true})
     add_includedirs("src/glad2/include")
+    add_includedirs("deps/stb")
 
     -- Source files
     add_files("src/*.cpp")